@@ -0,0 +1,100 @@
+############################################################
+#
+# Builds the light-transport kernel of the EL gap read by
+# Electroluminescence in kernel mode (ELSensorKernel, "NELK"
+# format) from a set of S2 light-table simulations.
+#
+# Each input file is a run of macros/NEXT100_S2_table.*.mac
+# (full optical simulation, ScintillationGenerator in the AD_HOC
+# region) with /Geometry/Next100/specific_vertex set to one node
+# of a regular grid in the EL gap, e.g.
+#
+#   for x in -500 ... 500, y in -500 ... 500 (step 10 mm):
+#     /Geometry/Next100/specific_vertex {x} {y} {z_EL} mm
+#     /nexus/persistency/outputFile Next100_X_{x}_Y_{y}.next
+#
+# The detection probability of a sensor at a node is the number
+# of photons it detects divided by the number of photons emitted
+# (nphotons x num_events). Nodes without an input file get no
+# entries, so the light of electrons crossing them is dropped.
+#
+############################################################
+
+input_files     = "Next100_X_*_Y_*.next.h5"
+output_file     = "NEXT100_EL_kernel.bin"
+min_probability = 1.e-7 # entries below this value are dropped
+
+############################################################
+
+import glob
+import struct
+
+import numpy  as np
+import pandas as pd
+
+
+def decode(column):
+    return column.apply(lambda v: v.decode() if isinstance(v, bytes) else str(v))
+
+
+def read_point(filename):
+    config  = pd.read_hdf(filename, "MC/configuration")
+    config  = dict(zip(decode(config.param_key), decode(config.param_value)))
+    vertex  = config["/Geometry/Next100/specific_vertex"].split()
+    scale   = {"mm": 1., "cm": 10., "m": 1000.}[vertex[3]]
+    photons = float(config["/Generator/ScintGenerator/nphotons"]) * \
+              float(config["num_events"])
+
+    sensors  = pd.read_hdf(filename, "MC/sns_positions")
+    sensors["sensor_name"] = decode(sensors.sensor_name)
+    response = pd.read_hdf(filename, "MC/sns_response")
+    charge   = response.groupby("sensor_id").charge.sum() / photons
+
+    return float(vertex[0]) * scale, float(vertex[1]) * scale, sensors, charge
+
+
+def regular_axis(values):
+    values = np.unique(np.round(values, 6))
+    if len(values) == 1:
+        return values[0], 1., 1
+    steps = np.diff(values)
+    if not np.allclose(steps, steps[0]):
+        raise ValueError("The vertices do not form a regular grid.")
+    return values[0], steps[0], len(values)
+
+
+points = [read_point(f) for f in sorted(glob.glob(input_files))]
+if not points:
+    raise ValueError("No input files match " + input_files)
+
+min_x, step_x, nx = regular_axis([p[0] for p in points])
+min_y, step_y, ny = regular_axis([p[1] for p in points])
+
+# Sensor ids are unique across sensitive detectors in nexus
+sensors  = pd.concat([p[2] for p in points]).drop_duplicates("sensor_id")
+sensors  = sensors.sort_values("sensor_id").reset_index(drop=True)
+sd_names = sorted(sensors.sensor_name.unique())
+index    = {sid: i for i, sid in enumerate(sensors.sensor_id)}
+
+entries = [[] for _ in range(nx * ny)]
+for x, y, _, charge in points:
+    node = int(round((y - min_y) / step_y)) * nx + int(round((x - min_x) / step_x))
+    entries[node] = [(index[sid], p) for sid, p in charge.items() if p >= min_probability]
+
+with open(output_file, "wb") as out:
+    out.write(b"NELK")
+    out.write(struct.pack("<5I4d", 1, len(sd_names), len(sensors), nx, ny,
+                          min_x, min_y, step_x, step_y))
+    for name in sd_names:
+        out.write(struct.pack("<I", len(name)) + name.encode())
+    for s in sensors.itertuples():
+        out.write(struct.pack("<iI3f", s.sensor_id, sd_names.index(s.sensor_name),
+                              s.x, s.y, s.z))
+    offset = 0
+    for node in entries:
+        out.write(struct.pack("<I", offset))
+        offset += len(node)
+    out.write(struct.pack("<I", offset))
+    for node in entries:
+        for sensor, probability in node:
+            out.write(struct.pack("<If", sensor, probability))
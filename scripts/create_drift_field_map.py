@@ -0,0 +1,63 @@
+############################################################
+#
+# Writes a drift field map for FieldMapDriftField ("NDFM"
+# format, see source/physics/FieldMapDriftField.h) covering
+# the active volume of NEXT-100.
+#
+# The drift lines are those of the uniform field that nexus
+# uses without a map (straight lines to the gate at z = 0,
+# same velocity and diffusion constants), so the map can be
+# used to validate the map-based drift against the uniform
+# one. For a field-solver map, replace drift_line() with the
+# interpolation of the solver output; it must return a
+# negative drift time for lines that do not reach the gate.
+#
+############################################################
+
+output_file = "NEXT100_drift_map.bin"
+
+radius      =  492.0  # mm, active region (centre of the panels)
+cathode_z   = 1193.05 # mm, the gate (anode of the drift) is at z = 0
+
+step_xy     =   10.0  # mm
+step_z      =   10.0  # mm
+
+drift_velocity = 1.0  # mm/us
+transv_diff    = 1.0  # mm/sqrt(cm)
+long_diff      = 0.3  # mm/sqrt(cm)
+
+############################################################
+
+import math
+import struct
+
+
+def drift_line(x, y, z):
+    """Return end point, drift time, path length and spreads
+    of the drift line starting at (x, y, z)."""
+    if x*x + y*y > radius*radius:
+        return x, y, 0., -1., 0., 0., 0.
+    length = z
+    time   = length / drift_velocity
+    sigma_transv = transv_diff * math.sqrt(length / 10.)
+    sigma_time   = long_diff   * math.sqrt(length / 10.) / drift_velocity
+    # The uniform field leaves the electrons 1 micrometre beyond the gate
+    return x, y, -0.001, time, length, sigma_transv, sigma_time
+
+
+# The grid covers the active region (cells that cross its edge
+# touch lost lines, so electrons there are lost)
+nxy = 2 * int(math.ceil(radius / step_xy)) + 1
+nz  = int(math.ceil(cathode_z / step_z)) + 1
+min_xy = -(nxy - 1) / 2 * step_xy
+
+with open(output_file, "wb") as out:
+    out.write(b"NDFM")
+    out.write(struct.pack("<5I6d", 1, nxy, nxy, nz, 0,
+                          min_xy, min_xy, 0., step_xy, step_xy, step_z))
+    # x runs fastest and z slowest
+    for k in range(nz):
+        for j in range(nxy):
+            for i in range(nxy):
+                record = drift_line(min_xy + i*step_xy, min_xy + j*step_xy, k*step_z)
+                out.write(struct.pack("<7f", *record))
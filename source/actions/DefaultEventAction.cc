@@ -12,6 +12,7 @@
 #include "PersistencyManager.h"
 #include "IonizationHit.h"
 #include "FactoryBase.h"
+#include "DefaultStackingAction.h"
 
 #include <G4Event.hh>
 #include <G4VVisManager.hh>
@@ -20,6 +21,7 @@
 #include <G4HCofThisEvent.hh>
 #include <G4SDManager.hh>
 #include <G4HCtable.hh>
+#include <G4RunManager.hh>
 #include <globals.hh>
 
 
@@ -100,7 +102,14 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
       } else {
 	pm->InteractingEvent(false);
       }
-      if (!event->IsAborted() && edep > energy_min_ && edep < energy_max_) {
+      // Events whose optical and drift stage was skipped by the
+      // early abort of DefaultStackingAction are incomplete
+      const DefaultStackingAction* stacking = dynamic_cast<const DefaultStackingAction*>
+        (G4RunManager::GetRunManager()->GetUserStackingAction());
+      G4bool early_abort = stacking && stacking->EventAborted();
+
+      if (!event->IsAborted() && !early_abort &&
+          edep > energy_min_ && edep < energy_max_) {
 	pm->StoreCurrentEvent(true);
       } else {
 	pm->StoreCurrentEvent(false);
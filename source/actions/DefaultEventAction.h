@@ -33,6 +33,10 @@ namespace nexus {
     /// Hook at the end of the event loop
     void EndOfEventAction(const G4Event*);
 
+    /// Window of deposited energy of the events saved to file
+    G4double GetMinEnergy() const { return energy_min_; }
+    G4double GetMaxEnergy() const { return energy_max_; }
+
   private:
     G4GenericMessenger* msg_;
     G4int nevt_, nupdate_;
@@ -1,36 +1,77 @@
 // ----------------------------------------------------------------------------
 // nexus | DefaultStackingAction.cc
 //
-// This class is an example of how to implement a stacking action, if needed.
-// At the moment, it is not used in the NEXT simulations.
+// This class implements an optional early abort of uninteresting events.
+// When enabled, optical photons and ionization electrons are postponed to
+// a second stage, which is only simulated if the energy deposited during
+// the first stage falls within the window of DefaultEventAction (the only
+// event action the early abort can be combined with).
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 
 #include "DefaultStackingAction.h"
+#include "DefaultEventAction.h"
 #include "FactoryBase.h"
+#include "Trajectory.h"
+#include "IonizationSD.h"
+#include "IonizationHit.h"
+#include "IonizationElectron.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4EventManager.hh>
+#include <G4Event.hh>
+#include <G4Track.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4TrajectoryContainer.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4SDManager.hh>
+#include <G4StackManager.hh>
+#include <G4RunManager.hh>
 
 
 using namespace nexus;
 
 REGISTER_CLASS(DefaultStackingAction, G4UserStackingAction)
 
-DefaultStackingAction::DefaultStackingAction(): G4UserStackingAction()
+DefaultStackingAction::DefaultStackingAction():
+  G4UserStackingAction(), msg_(0), early_abort_(false),
+  sd_name_(""), stage_(0), aborted_(false)
 {
+  msg_ = new G4GenericMessenger(this, "/Actions/DefaultStackingAction/");
+
+  msg_->DeclareProperty("early_abort", early_abort_,
+                        "Skip the optical and drift stage of events "
+                        "that are not going to be saved (the energy window "
+                        "is the one of /Actions/DefaultEventAction/).");
+
+  msg_->DeclareProperty("sensitive_detector", sd_name_,
+                        "Name of the ionization sensitive detector (e.g., ACTIVE) used for the "
+                        "trigger (all of them, if not set).");
 }
 
 
 
 DefaultStackingAction::~DefaultStackingAction()
 {
+  delete msg_;
 }
 
 
 
 G4ClassificationOfNewTrack
-DefaultStackingAction::ClassifyNewTrack(const G4Track* /*track*/)
+DefaultStackingAction::ClassifyNewTrack(const G4Track* track)
 {
+  if (!early_abort_ || stage_ > 0) return fUrgent;
+
+  // Optical photons and ionization electrons are only tracked
+  // once the rest of the event has been simulated
+  G4ParticleDefinition* pdef = track->GetDefinition();
+  if (pdef == G4OpticalPhoton::Definition() ||
+      pdef == IonizationElectron::Definition())
+    return fWaiting;
+
   return fUrgent;
 }
 
@@ -38,12 +79,77 @@ DefaultStackingAction::ClassifyNewTrack(const G4Track* /*track*/)
 
 void DefaultStackingAction::NewStage()
 {
-  return;
+  if (!early_abort_ || stage_++ > 0) return;
+
+  // Same window as in DefaultEventAction. The energy of the trigger may
+  // differ from the one used there (if sensitive_detector is set), so
+  // the event action is told not to save the events cut short here.
+  const DefaultEventAction* evt_action = EventAction();
+  G4double edep = EnergyDeposit();
+  if (!(edep > evt_action->GetMinEnergy() && edep < evt_action->GetMaxEnergy())) {
+    stackManager->clear();
+    aborted_ = true;
+  }
 }
 
 
 
 void DefaultStackingAction::PrepareNewEvent()
 {
-  return;
+  stage_   = 0;
+  aborted_ = false;
+}
+
+
+
+const DefaultEventAction* DefaultStackingAction::EventAction() const
+{
+  // The thresholds are read from the event action rather than duplicated
+  // here, so that both always agree
+  const DefaultEventAction* evt_action = dynamic_cast<const DefaultEventAction*>
+    (G4RunManager::GetRunManager()->GetUserEventAction());
+
+  if (!evt_action)
+    G4Exception("[DefaultStackingAction]", "EventAction()", FatalException,
+                "The early abort requires DefaultEventAction as event action.");
+
+  return evt_action;
+}
+
+
+
+G4double DefaultStackingAction::EnergyDeposit() const
+{
+  const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+
+  G4double edep = 0.;
+
+  // Without an explicit sensitive detector, use the total energy
+  // deposit stored in the trajectories, as DefaultEventAction does
+  if (sd_name_ == "") {
+    G4TrajectoryContainer* tc = event->GetTrajectoryContainer();
+    if (tc) {
+      for (unsigned int i=0; i<tc->size(); ++i) {
+        Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
+        if (trj) edep += trj->GetEnergyDeposit();
+      }
+    }
+    return edep;
+  }
+
+  G4HCofThisEvent* hce = event->GetHCofThisEvent();
+  if (!hce) return edep;
+
+  G4int hcid = G4SDManager::GetSDMpointer()->
+    GetCollectionID(sd_name_ + "/" + IonizationSD::GetCollectionUniqueName());
+  if (hcid < 0) return edep;
+
+  IonizationHitsCollection* hits =
+    dynamic_cast<IonizationHitsCollection*>(hce->GetHC(hcid));
+  if (!hits) return edep;
+
+  for (size_t i=0; i<hits->entries(); ++i)
+    edep += (*hits)[i]->GetEnergyDeposit();
+
+  return edep;
 }
@@ -1,8 +1,11 @@
 // ----------------------------------------------------------------------------
 // nexus | DefaultStackingAction.h
 //
-// This class is an example of how to implement a stacking action, if needed.
-// At the moment, it is not used in the NEXT simulations.
+// This class implements an optional early abort of uninteresting events.
+// When enabled, optical photons and ionization electrons are postponed to
+// a second stage, which is only simulated if the energy deposited during
+// the first stage falls within the window of DefaultEventAction (the only
+// event action the early abort can be combined with).
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -12,9 +15,13 @@
 
 #include <G4UserStackingAction.hh>
 
+class G4GenericMessenger;
+
 
 namespace nexus {
 
+  class DefaultEventAction;
+
   // General-purpose user stacking action
 
   class DefaultStackingAction: public G4UserStackingAction
@@ -28,8 +35,32 @@ namespace nexus {
     virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*);
     virtual void NewStage();
     virtual void PrepareNewEvent();
+
+    /// Has the optical and drift stage of the current event been skipped?
+    /// Such events are incomplete and must not be saved.
+    G4bool EventAborted() const;
+
+  private:
+    /// Event action that decides which events are saved
+    const DefaultEventAction* EventAction() const;
+    /// Energy deposited so far in the event in the ionization
+    /// sensitive detectors (or in the one chosen by the user)
+    G4double EnergyDeposit() const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4bool early_abort_; ///< Postpone the optical and drift stage?
+    G4String sd_name_;   ///< Sensitive detector used for the trigger
+
+    G4int stage_;     ///< Current stage of the event
+    G4bool aborted_;  ///< Was the second stage of the event skipped?
   };
 
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool DefaultStackingAction::EventAborted() const { return aborted_; }
+
 } // end namespace nexus
 
 #endif
@@ -15,12 +15,15 @@
 #include "TrajectoryMap.h"
 #include "IonizationElectron.h"
 #include "FactoryBase.h"
+#include "EventStats.h"
 
 #include <G4Track.hh>
 #include <G4TrackingManager.hh>
 #include <G4Trajectory.hh>
 #include <G4ParticleDefinition.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4VProcess.hh>
+#include <G4EmProcessSubType.hh>
 
 using namespace nexus;
 
@@ -36,6 +39,12 @@ DefaultTrackingAction::~DefaultTrackingAction()
 
 void DefaultTrackingAction::PreUserTrackingAction(const G4Track *track)
 {
+  // Count the optical photons produced by scintillation
+  if (track->GetDefinition() == G4OpticalPhoton::Definition() &&
+      track->GetCreatorProcess() &&
+      track->GetCreatorProcess()->GetProcessSubType() == fScintillation)
+    EventStats::AddScintillationPhotons(1);
+
   // Do nothing if the track is an optical photon or an ionization electron
   if (track->GetDefinition() == G4OpticalPhoton::Definition() ||
       track->GetDefinition() == IonizationElectron::Definition())
@@ -58,6 +67,11 @@ void DefaultTrackingAction::PreUserTrackingAction(const G4Track *track)
 
 void DefaultTrackingAction::PostUserTrackingAction(const G4Track *track)
 {
+  // Count the steps of the track, unless it is only suspended
+  // (in which case it will be resumed and counted later on)
+  if (track->GetTrackStatus() != fSuspend)
+    EventStats::AddSteps(track->GetCurrentStepNumber());
+
   // Do nothing if the track is an optical photon or an ionization electron
   if (track->GetDefinition() == G4OpticalPhoton::Definition() ||
       track->GetDefinition() == IonizationElectron::Definition())
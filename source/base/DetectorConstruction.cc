@@ -8,6 +8,7 @@
 
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
+#include "StartupTimer.h"
 
 #include <G4Box.hh>
 #include <G4Material.hh>
@@ -44,7 +45,9 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   // At this point the user should have loaded the configuration
   // parameters of the geometry or it will get built with the
   // default values.
+  StartupTimer::Start("geometry");
   geometry_->Construct();
+  StartupTimer::Stop("geometry");
 
   // We define now the world volume as an empty box big enough
   // to fit the user's geometry inside.
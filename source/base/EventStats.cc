@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+// nexus | EventStats.cc
+//
+// This class collects per-event performance counters (number of steps,
+// optical photons, ionization electrons, detected photons) and the
+// wall-clock and CPU time spent in the event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "EventStats.h"
+
+#include <CLHEP/Units/SystemOfUnits.h>
+
+
+G4long nexus::EventStats::steps_            = 0;
+G4long nexus::EventStats::el_photons_       = 0;
+G4long nexus::EventStats::scint_photons_    = 0;
+G4long nexus::EventStats::ie_               = 0;
+G4long nexus::EventStats::detected_photons_ = 0;
+
+std::chrono::steady_clock::time_point nexus::EventStats::wall_start_;
+std::clock_t nexus::EventStats::cpu_start_ = 0;
+G4double nexus::EventStats::wall_time_ = 0.;
+G4double nexus::EventStats::cpu_time_  = 0.;
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+
+  void EventStats::Start()
+  {
+    steps_            = 0;
+    el_photons_       = 0;
+    scint_photons_    = 0;
+    ie_               = 0;
+    detected_photons_ = 0;
+
+    wall_time_ = 0.;
+    cpu_time_  = 0.;
+
+    wall_start_ = std::chrono::steady_clock::now();
+    cpu_start_  = std::clock();
+  }
+
+
+
+  void EventStats::Stop()
+  {
+    std::chrono::duration<G4double> wall =
+      std::chrono::steady_clock::now() - wall_start_;
+    wall_time_ = wall.count() * second;
+    cpu_time_  = G4double(std::clock() - cpu_start_) / CLOCKS_PER_SEC * second;
+  }
+
+} // namespace nexus
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | EventStats.h
+//
+// This class collects per-event performance counters (number of steps,
+// optical photons, ionization electrons, detected photons) and the
+// wall-clock and CPU time spent in the event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EVENT_STATS_H
+#define EVENT_STATS_H
+
+#include <globals.hh>
+
+#include <chrono>
+#include <ctime>
+
+
+namespace nexus {
+
+  class EventStats
+  {
+  public:
+    /// Reset the counters and start the event timers
+    static void Start();
+    /// Stop the event timers
+    static void Stop();
+
+    static void AddSteps(G4long n);
+    static void AddELPhotons(G4long n);
+    static void AddScintillationPhotons(G4long n);
+    static void AddIonizationElectrons(G4long n);
+    static void AddDetectedPhotons(G4long n);
+
+    static G4long GetSteps();
+    static G4long GetELPhotons();
+    static G4long GetScintillationPhotons();
+    static G4long GetIonizationElectrons();
+    static G4long GetDetectedPhotons();
+
+    /// Wall-clock time spent in the event (in G4 units)
+    static G4double GetWallTime();
+    /// CPU time spent in the event (in G4 units)
+    static G4double GetCPUTime();
+
+  private:
+    // Constructors, destructor and assignement op are hidden
+    // so that no instance of the class can be created.
+    EventStats();
+    EventStats(const EventStats&);
+    ~EventStats();
+
+  private:
+    static G4long steps_;
+    static G4long el_photons_;
+    static G4long scint_photons_;
+    static G4long ie_;
+    static G4long detected_photons_;
+
+    static std::chrono::steady_clock::time_point wall_start_;
+    static std::clock_t cpu_start_;
+    static G4double wall_time_;
+    static G4double cpu_time_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void EventStats::AddSteps(G4long n) { steps_ += n; }
+  inline void EventStats::AddELPhotons(G4long n) { el_photons_ += n; }
+  inline void EventStats::AddScintillationPhotons(G4long n) { scint_photons_ += n; }
+  inline void EventStats::AddIonizationElectrons(G4long n) { ie_ += n; }
+  inline void EventStats::AddDetectedPhotons(G4long n) { detected_photons_ += n; }
+
+  inline G4long EventStats::GetSteps() { return steps_; }
+  inline G4long EventStats::GetELPhotons() { return el_photons_; }
+  inline G4long EventStats::GetScintillationPhotons() { return scint_photons_; }
+  inline G4long EventStats::GetIonizationElectrons() { return ie_; }
+  inline G4long EventStats::GetDetectedPhotons() { return detected_photons_; }
+
+  inline G4double EventStats::GetWallTime() { return wall_time_; }
+  inline G4double EventStats::GetCPUTime() { return cpu_time_; }
+
+} // namespace nexus
+
+#endif
@@ -15,6 +15,10 @@
 #include "DetectorConstruction.h"
 #include "PrimaryGeneration.h"
 #include "FactoryBase.h"
+#include "StartupTimer.h"
+#include "PhiloxEngine.h"
+#include "CacheFile.h"
+#include "EventStats.h"
 
 #include <G4GenericPhysicsList.hh>
 #include <G4UImanager.hh>
@@ -26,17 +30,76 @@
 #include <G4UserTrackingAction.hh>
 #include <G4UserSteppingAction.hh>
 #include <G4UserStackingAction.hh>
+#include <G4VUserPhysicsList.hh>
+#include <G4Version.hh>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
 
 using namespace nexus;
 using std::make_unique;
 using std::unique_ptr;
 
 
+namespace {
+
+  // Commands that change the physics tables: those of the geometry
+  // (materials, production cuts) and of the physics lists. Per-job
+  // commands (seed, output file, start ID...) are left out, so that
+  // the jobs of a production share their cache entry.
+  const std::vector<std::string> TABLE_COMMANDS =
+    {"/nexus/RegisterGeometry", "/Geometry/", "/PhysicsList/",
+     "/physics_lists/", "/Physics/", "/process/", "/run/setCut",
+     "/cuts/", "/material/"};
+
+  /// Append to commands those of a macro file (and of the macros it
+  /// executes) that change the physics tables, without comments or
+  /// redundant whitespace
+  void TableCommands(const std::string& filename,
+                     std::vector<std::string>& commands, int depth=0)
+  {
+    std::ifstream macro(filename);
+    std::string line;
+    while (std::getline(macro, line)) {
+      line = line.substr(0, line.find('#'));
+      std::istringstream iss(line);
+      std::string word, command;
+      while (iss >> word) command += (command.empty() ? "" : " ") + word;
+      if (command.empty()) continue;
+
+      if (command.rfind("/control/execute ", 0) == 0) {
+        // Guard against macros executing themselves
+        if (depth < 16) TableCommands(command.substr(17), commands, depth+1);
+        continue;
+      }
+
+      for (const auto& prefix: TABLE_COMMANDS) {
+        if (command.rfind(prefix, 0) == 0) {
+          commands.push_back(command);
+          break;
+        }
+      }
+    }
+  }
+
+} // namespace
+
+
 NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
                                          geo_name_(""), pm_name_(""),
                                          runact_name_(""), evtact_name_(""),
                                          stepact_name_(""), trkact_name_(""),
-                                         stkact_name_("")
+                                         stkact_name_(""), first_run_(true),
+                                         init_macro_(init_macro),
+                                         table_cache_dir_(""),
+                                         table_cache_path_(""),
+                                         store_tables_(false),
+                                         default_engine_(nullptr),
+                                         user_seed_(false),
+                                         shard_index_(-1), shard_count_(0),
+                                         job_events_(0)
 {
   // Create and configure a generic messenger for the app
   msg_ = make_unique<G4GenericMessenger>(this, "/nexus/", "Nexus control commands.");
@@ -55,6 +118,20 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   msg_->DeclareMethod("random_seed", &NexusApp::SetRandomSeed,
                       "Set a seed for the random number generator.");
 
+  // Define a command to make the random numbers of each event
+  // reproducible independently of the rest of the job
+  msg_->DeclareMethod("random_per_event", &NexusApp::SetRandomPerEvent,
+                      "Derive the random numbers of each event from the seed "
+                      "and the event number only.");
+
+  // Define a command to run one of the shards of a production
+  msg_->DeclareMethod("shard", &NexusApp::SetShard,
+                      "Run shard i (from 0) of N of the production: i N.");
+
+  // Define a command to reuse the physics tables across jobs
+  msg_->DeclareMethod("physics_table_cache", &NexusApp::SetPhysicsTableCache,
+                      "Directory where physics tables are cached between jobs.");
+
 // Define the command to set the desired generator
   msg_->DeclareProperty("RegisterGenerator", gen_name_, "");
 
@@ -84,7 +161,13 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   // processing the init macro, where the physics lists are registered
   auto pl = make_unique<G4GenericPhysicsList>();
 
+  StartupTimer::Start("init_macro");
   BatchSession(init_macro.c_str()).SessionStart();
+  StartupTimer::Stop("init_macro");
+
+  // Time the creation of the user classes (their constructors
+  // define the messenger commands used in the configuration macros)
+  StartupTimer::Start("user_classes");
 
   // Set the physics list in the run manager
   this->SetUserInitialization(pl.release());
@@ -110,6 +193,8 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   }
   pm_ = ObjFactory<PersistencyManagerBase>::Instance().CreateObject(pm_name_);
   pm_->SetMacros(init_macro, macros_, delayed_);
+  if (shard_count_ > 0) pm_->SetShard(shard_index_, shard_count_);
+  pm_->SetIDFromEventNumber(bool(event_engine_));
 
  // PersistencyManager::Initialize(init_macro, macros_, delayed_);
 
@@ -139,6 +224,7 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
     this->SetUserAction(stepact.release());
   }
 
+  StartupTimer::Stop("user_classes");
 
   /////////////////////////////////////////////////////////
 
@@ -154,6 +240,9 @@ NexusApp::~NexusApp()
 {
   // Close output file before finishing
   pm_->CloseFile();
+
+  // Hand back the default engine before deleting the per-event one
+  if (default_engine_) CLHEP::HepRandom::setTheEngine(default_engine_);
 }
 
 
@@ -180,15 +269,35 @@ void NexusApp::Initialize()
   // so that all objects get configured
   // G4UImanager* UI = G4UImanager::GetUIpointer();
 
+  StartupTimer::Start("config_macros");
   for (unsigned int i=0; i<macros_.size(); i++) {
     ExecuteMacroFile(macros_[i].data());
   }
+  StartupTimer::Stop("config_macros");
 
+  StartupTimer::Start("run_manager");
   G4RunManager::Initialize();
+  StartupTimer::Stop("run_manager");
 
+  StartupTimer::Start("delayed_macros");
   for (unsigned int j=0; j<delayed_.size(); j++) {
     ExecuteMacroFile(delayed_[j].data());
   }
+  StartupTimer::Stop("delayed_macros");
+
+  // Once all the macros have been executed, the configuration of the job
+  // is known and we can look for physics tables built by a previous job
+  if (table_cache_dir_ != "") {
+    table_cache_path_ = table_cache_dir_ + "/" + ConfigurationHash();
+    if (std::filesystem::exists(table_cache_path_ + "/complete")) {
+      G4cout << "### Retrieving physics tables from "
+             << table_cache_path_ << G4endl;
+      physicsList->SetPhysicsTableRetrieved(table_cache_path_);
+    }
+    else {
+      store_tables_ = true;
+    }
+  }
 
   // Execute command to enable triggering of sensitive detectors.
   // If the optical physics is not loaded, it is not applied,
@@ -199,6 +308,47 @@ void NexusApp::Initialize()
 
 
 
+void NexusApp::InitializeGeometry()
+{
+  StartupTimer::Start("run_manager/geometry");
+  G4RunManager::InitializeGeometry();
+  StartupTimer::Stop("run_manager/geometry");
+}
+
+
+
+void NexusApp::InitializePhysics()
+{
+  StartupTimer::Start("run_manager/physics");
+  G4RunManager::InitializePhysics();
+  StartupTimer::Stop("run_manager/physics");
+}
+
+
+
+void NexusApp::RunInitialization()
+{
+  // Only the first run builds the physics tables, so the
+  // following runs are not timed
+  if (!first_run_) {
+    G4RunManager::RunInitialization();
+    return;
+  }
+
+  StartupTimer::Start("physics_tables");
+  G4RunManager::RunInitialization();
+  StartupTimer::Stop("physics_tables");
+
+  first_run_ = false;
+
+  if (store_tables_) StorePhysicsTables();
+
+  // The initialization is now complete
+  StartupTimer::Print();
+}
+
+
+
 void NexusApp::ExecuteMacroFile(const char* filename)
 {
   G4UImanager* UI = G4UImanager::GetUIpointer();
@@ -217,4 +367,161 @@ void NexusApp::SetRandomSeed(G4int seed)
   // we will set as seed the system time.
   if (seed < 0) CLHEP::HepRandom::setTheSeed(time(0));
   else CLHEP::HepRandom::setTheSeed(seed);
+  user_seed_ = (seed >= 0);
+}
+
+
+
+void NexusApp::SetRandomPerEvent(G4bool per_event)
+{
+  if (per_event == bool(event_engine_)) return;
+
+  if (per_event) {
+    // The per-event engine takes the seed already set
+    default_engine_ = CLHEP::HepRandom::getTheEngine();
+    event_engine_ = make_unique<PhiloxEngine>(CLHEP::HepRandom::getTheSeed());
+    CLHEP::HepRandom::setTheEngine(event_engine_.get());
+  }
+  else {
+    CLHEP::HepRandom::setTheEngine(default_engine_);
+    default_engine_ = nullptr;
+    event_engine_.reset();
+  }
+
+  if (pm_) pm_->SetIDFromEventNumber(per_event);
+}
+
+
+
+G4Event* NexusApp::GenerateEvent(G4int i_event)
+{
+  // The stream of the event is numbered as the event in the output
+  // file, so that a job split in several ones (each with its own
+  // start_id) reproduces the events of the full job. The start ID
+  // includes the events of the previous runs, so that every run of
+  // the job generates new events.
+  if (event_engine_)
+    event_engine_->SetEvent(pm_->GetStartID() + i_event);
+
+  // The counters are handled here, rather than in a user action,
+  // so that they are right whatever the actions of the job
+  EventStats::Start();
+
+  return G4RunManager::GenerateEvent(i_event);
+}
+
+
+
+void NexusApp::AnalyzeEvent(G4Event* event)
+{
+  EventStats::Stop();
+  G4RunManager::AnalyzeEvent(event);
+}
+
+
+
+void NexusApp::SetShard(G4String params)
+{
+  std::istringstream iss(params);
+  G4int index, count;
+  if (!(iss >> index >> count) || count < 1 || index < 0 || index >= count)
+    G4Exception("[NexusApp]", "SetShard()", FatalException,
+                "Expected: shard index (from 0) and number of shards.");
+
+  shard_index_ = index;
+  shard_count_ = count;
+
+  // The shards of a production share the seed and differ in
+  // their events, each with its own random stream
+  SetRandomPerEvent(true);
+
+  if (pm_) pm_->SetShard(shard_index_, shard_count_);
+}
+
+
+
+void NexusApp::BeamOn(G4int n_event, const char* macroFile, G4int n_select)
+{
+  // The events of the run follow those of the previous runs of the job
+  pm_->SetRunOffset(job_events_);
+  G4int production_events = n_event;
+
+  if (shard_count_ > 0) {
+    if (!user_seed_)
+      G4Exception("[NexusApp]", "BeamOn()", JustWarning,
+                  "The shards of a production are only reproducible with a fixed random seed.");
+
+    G4int first = G4int(G4long(n_event) * shard_index_ / shard_count_);
+    G4int last  = G4int(G4long(n_event) * (shard_index_ + 1) / shard_count_);
+    pm_->SetShardRange(first, last - first);
+    n_event = last - first;
+
+    // Generators reading their events in order from a file
+    // start at the first event of the shard
+    PrimaryGeneration* pg =
+      dynamic_cast<PrimaryGeneration*>(userPrimaryGeneratorAction);
+    if (pg) pg->SetEventOffset(job_events_ + first);
+  }
+
+  G4RunManager::BeamOn(n_event, macroFile, n_select);
+
+  job_events_ += production_events;
+}
+
+
+
+void NexusApp::SetPhysicsTableCache(G4String dir)
+{
+  table_cache_dir_ = dir;
+}
+
+
+
+G4String NexusApp::ConfigurationHash() const
+{
+  // 64-bit FNV-1a hash of the commands of the job that affect the
+  // physics tables and of the Geant4 version, since the format of the
+  // physics tables may change from one version to another.
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const std::string& str) {
+    for (unsigned char c: str) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  add(G4Version);
+
+  std::vector<G4String> files = {init_macro_};
+  files.insert(files.end(), macros_.begin(), macros_.end());
+  files.insert(files.end(), delayed_.begin(), delayed_.end());
+
+  std::vector<std::string> commands;
+  for (const auto& f: files) TableCommands(f, commands);
+  for (const auto& c: commands) add(c + "\n");
+
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return ss.str();
+}
+
+
+
+void NexusApp::StorePhysicsTables()
+{
+  G4bool stored = WriteAtomically(table_cache_path_, [this](const std::string& tmp_path) {
+    std::error_code ec;
+    std::filesystem::create_directories(tmp_path, ec);
+    if (ec || !physicsList->StorePhysicsTable(tmp_path)) return false;
+    std::ofstream(tmp_path + "/complete") << G4Version << std::endl;
+    return true;
+  });
+
+  if (stored)
+    G4cout << "### Physics tables stored in " << table_cache_path_ << G4endl;
+  else
+    G4Exception("[NexusApp]", "StorePhysicsTables()", JustWarning,
+                "Unable to store the physics tables in the cache.");
+
+  store_tables_ = false;
 }
@@ -17,9 +17,13 @@
 
 class G4GenericMessenger;
 
+namespace CLHEP { class HepRandomEngine; }
+
 
 namespace nexus {
 
+  class PhiloxEngine;
+
   class NexusApp: public G4RunManager
   {
   public:
@@ -30,9 +34,21 @@ namespace nexus {
 
     virtual void Initialize();
 
+    /// Overriden to time the construction of the geometry
+    virtual void InitializeGeometry();
+    /// Overriden to time the construction of the physics processes
+    virtual void InitializePhysics();
+    /// Overriden to time the building of the physics tables,
+    /// which happens at the beginning of the first run
+    virtual void RunInitialization();
+
     /// Returns the number of events to be processed in the current run
     G4int GetNumberOfEventsToBeProcessed() const;
 
+    /// In a sharded job, n_event is the number of events of the whole
+    /// production and only the range of events of the shard is run
+    virtual void BeamOn(G4int n_event, const char* macroFile=0, G4int n_select=-1);
+
   private:
     void RegisterMacro(G4String);
 
@@ -44,6 +60,30 @@ namespace nexus {
     /// If a negative value is chosen, the system time is set as seed.
     void SetRandomSeed(G4int);
 
+    /// Use a counter-based random engine whose stream for each event
+    /// only depends on the seed and the event number
+    void SetRandomPerEvent(G4bool);
+
+    /// Start the random stream and the performance counters
+    /// of the event before generating it
+    virtual G4Event* GenerateEvent(G4int i_event);
+    /// Stop the timers of the event before it is stored
+    virtual void AnalyzeEvent(G4Event*);
+
+    /// Make the job shard i (counting from 0) of N of a production
+    void SetShard(G4String);
+
+    /// Set a directory where the physics tables are cached, so that
+    /// jobs with the same geometry and physics can reuse them.
+    void SetPhysicsTableCache(G4String);
+
+    /// Return a hash of the commands of the job (including those of the
+    /// macros they execute) that change the physics tables
+    G4String ConfigurationHash() const;
+
+    /// Store the physics tables built in the first run in the cache
+    void StorePhysicsTables();
+
   private:
     std::unique_ptr<G4GenericMessenger> msg_;
     G4String gen_name_; ///< Name of the chosen primary generator
@@ -60,6 +100,21 @@ namespace nexus {
 
     std::unique_ptr<PersistencyManagerBase> pm_;
 
+    G4bool first_run_; ///< True until the first run has been initialized
+
+    G4String init_macro_; ///< Name of the initialization macro
+    G4String table_cache_dir_; ///< Directory where physics tables are cached
+    G4String table_cache_path_; ///< Cache entry for the current configuration
+    G4bool store_tables_; ///< Should the physics tables be stored after building them?
+
+    std::unique_ptr<PhiloxEngine> event_engine_; ///< Per-event random engine
+    CLHEP::HepRandomEngine* default_engine_; ///< Engine replaced by the per-event one
+    G4bool user_seed_; ///< Has the user chosen the random seed?
+
+    G4int shard_index_; ///< Index of the shard of the production (or -1)
+    G4int shard_count_; ///< Number of shards of the production
+    G4int job_events_;  ///< Events of the previous runs of the job
+
   };
 
   // INLINE DEFINITIONS ////////////////////////////////////
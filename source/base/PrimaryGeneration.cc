@@ -2,30 +2,70 @@
 // nexus | PrimaryGeneration.cc
 //
 // This is a mandatory class which initializes the generation of
-// primary particles in a nexus event.
+// primary particles in a nexus event. Optionally, it overlays several
+// decays of the generator within an acquisition window (pile-up).
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 #include "PrimaryGeneration.h"
+#include "SequentialGenerator.h"
+#include "PrimaryVertexUtils.h"
 
 #include <G4Event.hh>
 #include <G4VPrimaryGenerator.hh>
+#include <G4GenericMessenger.hh>
+#include <G4Poisson.hh>
+#include <Randomize.hh>
+
+#include "CLHEP/Units/SystemOfUnits.h"
 
 
 using namespace nexus;
+using namespace CLHEP;
 
 
 
 PrimaryGeneration::PrimaryGeneration():
-  G4VUserPrimaryGeneratorAction(), generator_(nullptr)
+  G4VUserPrimaryGeneratorAction(), msg_(nullptr), generator_(nullptr),
+  pileup_(false), rate_(0.), time_window_(1.*ms), time_dist_("uniform"),
+  lifetime_(1.*ms)
 {
+  msg_ = new G4GenericMessenger(this, "/Generator/PileUp/",
+                                "Control commands of the pile-up of decays.");
+
+  msg_->DeclareProperty("enable", pileup_,
+                        "Overlay several decays of the generator in each event.");
+
+  G4GenericMessenger::Command& rate_cmd =
+    msg_->DeclarePropertyWithUnit("rate", "Hz", rate_,
+                                  "Rate of decays of the source.");
+  rate_cmd.SetParameterName("rate", false);
+  rate_cmd.SetRange("rate>=0.");
+
+  G4GenericMessenger::Command& window_cmd =
+    msg_->DeclarePropertyWithUnit("time_window", "ms", time_window_,
+                                  "Length of the acquisition window.");
+  window_cmd.SetParameterName("time_window", false);
+  window_cmd.SetRange("time_window>0.");
+
+  G4GenericMessenger::Command& dist_cmd =
+    msg_->DeclareProperty("time_distribution", time_dist_,
+                          "Distribution of the start times of the pile-up decays.");
+  dist_cmd.SetCandidates("uniform exponential");
+
+  G4GenericMessenger::Command& lifetime_cmd =
+    msg_->DeclarePropertyWithUnit("lifetime", "ms", lifetime_,
+                                  "Time constant of the exponential distribution.");
+  lifetime_cmd.SetParameterName("lifetime", false);
+  lifetime_cmd.SetRange("lifetime>0.");
 }
 
 
 
 PrimaryGeneration::~PrimaryGeneration()
 {
+  delete msg_;
 }
 
 
@@ -36,5 +76,43 @@ void PrimaryGeneration::GeneratePrimaries(G4Event* event)
     G4Exception("[PrimaryGeneration]", "GeneratePrimaries()",
                 FatalException, "Generator not set!");
 
+  // The decay that triggers the event starts at t=0
   generator_->GeneratePrimaryVertex(event);
+
+  if (!pileup_) return;
+
+  // Overlay a Poisson number of decays within the acquisition window.
+  // They share the rest of the event simulation (drift, EL, sensors).
+  G4long n = G4Poisson(rate_ * time_window_);
+  for (G4long i=0; i<n; ++i)
+    GenerateDelayedVertices(*generator_, event, PileUpTime());
+}
+
+
+
+void PrimaryGeneration::SetEventOffset(G4int n)
+{
+  SequentialGenerator* sequential =
+    dynamic_cast<SequentialGenerator*>(generator_.get());
+  if (!sequential || !sequential->ReadsInputFile()) return;
+
+  // With pile-up, each event reads a random number of input events
+  if (pileup_ && n > 0)
+    G4Exception("[PrimaryGeneration]", "SetEventOffset()", FatalException,
+                "Cannot skip the events of an input file with pile-up enabled.");
+
+  sequential->SetEventOffset(n);
+}
+
+
+
+G4double PrimaryGeneration::PileUpTime() const
+{
+  if (time_dist_ == "exponential") {
+    // Exponential distribution truncated to the window
+    G4double norm = 1. - std::exp(-time_window_ / lifetime_);
+    return -lifetime_ * std::log(1. - G4UniformRand() * norm);
+  }
+
+  return G4UniformRand() * time_window_;
 }
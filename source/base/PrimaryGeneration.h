@@ -2,7 +2,8 @@
 // nexus | PrimaryGeneration.h
 //
 // This is a mandatory class which initializes the generation of
-// primary particles in a nexus event.
+// primary particles in a nexus event. Optionally, it overlays several
+// decays of the generator within an acquisition window (pile-up).
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -14,6 +15,7 @@
 #include <globals.hh>
 
 class G4VPrimaryGenerator;
+class G4GenericMessenger;
 
 namespace nexus {
 
@@ -33,8 +35,25 @@ namespace nexus {
     /// Returns a pointer to the primary generator
     const G4VPrimaryGenerator* GetGenerator() const;
 
+    /// Make a generator reading its events from a file skip this
+    /// number of them (see SequentialGenerator). Other generators
+    /// are not affected.
+    void SetEventOffset(G4int);
+
+  private:
+    /// Random start time of a pile-up decay within the window
+    G4double PileUpTime() const;
+
   private:
+    G4GenericMessenger* msg_;
+
     std::unique_ptr<G4VPrimaryGenerator> generator_; ///< Pointer to the primary generator
+
+    G4bool pileup_;          ///< Overlay several decays per event?
+    G4double rate_;          ///< Rate of decays of the source
+    G4double time_window_;   ///< Length of the acquisition window
+    G4String time_dist_;     ///< Distribution of the start times (uniform or exponential)
+    G4double lifetime_;      ///< Time constant of the exponential distribution
   };
 
   // INLINE DEFINITIONS //////////////////////////////////////////////
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------------------
+// nexus | StartupTimer.cc
+//
+// This class keeps track of the wall-clock time spent in the different
+// phases of the initialization of nexus (macro processing, geometry
+// construction, physics tables, etc.).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "StartupTimer.h"
+
+#include <G4ios.hh>
+#include <G4Exception.hh>
+
+#include <CLHEP/Units/SystemOfUnits.h>
+
+#include <iomanip>
+
+
+std::vector<std::pair<G4String, G4double>> nexus::StartupTimer::phases_;
+std::map<G4String, std::chrono::steady_clock::time_point> nexus::StartupTimer::running_;
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+
+  void StartupTimer::Start(const G4String& phase)
+  {
+    running_[phase] = std::chrono::steady_clock::now();
+  }
+
+
+
+  void StartupTimer::Stop(const G4String& phase)
+  {
+    auto it = running_.find(phase);
+    if (it == running_.end()) {
+      G4String msg = "Phase '" + phase + "' was stopped without being started.";
+      G4Exception("[StartupTimer]", "Stop()", JustWarning, msg);
+      return;
+    }
+
+    std::chrono::duration<G4double> elapsed =
+      std::chrono::steady_clock::now() - it->second;
+    running_.erase(it);
+
+    for (auto& p: phases_) {
+      if (p.first == phase) {
+        p.second += elapsed.count() * second;
+        return;
+      }
+    }
+    phases_.push_back(std::make_pair(phase, elapsed.count() * second));
+  }
+
+
+
+  const std::vector<std::pair<G4String, G4double>>& StartupTimer::GetPhases()
+  {
+    return phases_;
+  }
+
+
+
+  void StartupTimer::Print()
+  {
+    G4cout << "### Initialization time per phase:" << G4endl;
+    for (const auto& p: phases_) {
+      G4cout << "    " << std::left << std::setw(40) << p.first
+             << std::right << std::fixed << std::setprecision(3)
+             << std::setw(10) << p.second/second << " s" << G4endl;
+    }
+    G4cout.unsetf(std::ios_base::floatfield);
+    G4cout << std::setprecision(6);
+  }
+
+} // namespace nexus
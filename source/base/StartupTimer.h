@@ -0,0 +1,53 @@
+// ----------------------------------------------------------------------------
+// nexus | StartupTimer.h
+//
+// This class keeps track of the wall-clock time spent in the different
+// phases of the initialization of nexus (macro processing, geometry
+// construction, physics tables, etc.).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef STARTUP_TIMER_H
+#define STARTUP_TIMER_H
+
+#include <G4String.hh>
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+
+namespace nexus {
+
+  class StartupTimer
+  {
+  public:
+    /// Start measuring the time spent in a given phase
+    static void Start(const G4String& phase);
+    /// Stop measuring the time spent in a given phase. If the phase
+    /// has been timed before, the elapsed time is added to its total.
+    static void Stop(const G4String& phase);
+
+    /// Return the timed phases, in the order they were first started,
+    /// together with the total time (in G4 units) spent in each of them
+    static const std::vector<std::pair<G4String, G4double>>& GetPhases();
+
+    /// Print a summary of the time spent in each phase
+    static void Print();
+
+  private:
+    // Constructors, destructor and assignement op are hidden
+    // so that no instance of the class can be created.
+    StartupTimer();
+    StartupTimer(const StartupTimer&);
+    ~StartupTimer();
+
+  private:
+    static std::vector<std::pair<G4String, G4double>> phases_;
+    static std::map<G4String, std::chrono::steady_clock::time_point> running_;
+  };
+
+} // namespace nexus
+
+#endif
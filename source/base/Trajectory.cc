@@ -25,7 +25,7 @@ G4Allocator<Trajectory> TrjAllocator;
 
 Trajectory::Trajectory(const G4Track* track):
   G4VTrajectory(), pdef_(0), trackId_(-1), parentId_(-1),
-  initial_time_(0.), final_time_(0), length_(0.), edep_(0.),
+  initial_time_(0.), final_time_(0), initial_weight_(1.), length_(0.), edep_(0.),
   record_trjpoints_(true), trjpoints_(0)
 {
   pdef_     = track->GetDefinition();
@@ -40,6 +40,7 @@ Trajectory::Trajectory(const G4Track* track):
   initial_momentum_ = track->GetMomentum();
   initial_position_ = track->GetVertexPosition();
   initial_time_ = track->GetGlobalTime();
+  initial_weight_ = track->GetWeight();
   initial_volume_ = track->GetVolume()->GetName();
 
   trjpoints_ = new TrajectoryPointContainer();
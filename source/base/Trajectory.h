@@ -68,6 +68,8 @@ namespace nexus {
     // Return creation time with respect to
     // the start-of-event time
     G4double GetInitialTime() const;
+    // Return statistical weight of the track at creation
+    G4double GetInitialWeight() const;
 
     G4ThreeVector GetFinalMomentum() const;
     void SetFinalMomentum(const G4ThreeVector&);
@@ -130,6 +132,8 @@ namespace nexus {
     G4double initial_time_;
     G4double final_time_;
 
+    G4double initial_weight_;
+
     G4double length_;
     G4double edep_;
 
@@ -199,6 +203,9 @@ inline void nexus::Trajectory::SetFinalPosition(const G4ThreeVector& x)
 inline G4double nexus::Trajectory::GetInitialTime() const
 { return initial_time_; }
 
+inline G4double nexus::Trajectory::GetInitialWeight() const
+{ return initial_weight_; }
+
 inline G4double nexus::Trajectory::GetFinalTime() const
 { return final_time_; }
 
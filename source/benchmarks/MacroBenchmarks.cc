@@ -0,0 +1,48 @@
+#include <NexusApp.h>
+
+#include <G4UImanager.hh>
+#include <Randomize.hh>
+
+#include <catch.hpp>
+
+
+// End-to-end benchmarks running complete events of the NEXT-100 detector.
+// They are hidden by default, since they take much longer than the rest
+// and need the macros of the repository, so they must be run explicitly
+// from the top directory of nexus, with a reduced number of samples, e.g.,
+//   nexus-benchmark "[macro]" --benchmark-samples 10
+TEST_CASE("NEXT-100 events", "[.][macro]") {
+
+  const long seed = 12345;
+
+  auto app = new nexus::NexusApp("macros/benchmarks/NEXT100_benchmark.init.mac");
+  app->Initialize();
+
+  G4UImanager* UI = G4UImanager::GetUIpointer();
+
+  // Every sample simulates exactly the same events
+  UI->ApplyCommand("/Generator/SingleParticle/min_energy 2.458 MeV");
+  UI->ApplyCommand("/Generator/SingleParticle/max_energy 2.458 MeV");
+  BENCHMARK("2.458 MeV electron") {
+    G4Random::setTheSeed(seed);
+    app->BeamOn(1);
+  };
+
+  UI->ApplyCommand("/Generator/SingleParticle/min_energy 41.5 keV");
+  UI->ApplyCommand("/Generator/SingleParticle/max_energy 41.5 keV");
+  BENCHMARK("41.5 keV electron") {
+    G4Random::setTheSeed(seed);
+    app->BeamOn(1);
+  };
+
+  UI->ApplyCommand("/Generator/SingleParticle/particle gamma");
+  UI->ApplyCommand("/Generator/SingleParticle/min_energy 2.615 MeV");
+  UI->ApplyCommand("/Generator/SingleParticle/max_energy 2.615 MeV");
+  BENCHMARK("2.615 MeV gamma") {
+    G4Random::setTheSeed(seed);
+    app->BeamOn(1);
+  };
+
+  delete app;
+
+}
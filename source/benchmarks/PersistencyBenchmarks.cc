@@ -0,0 +1,48 @@
+#include <HDF5Writer.h>
+
+#include <cstdio>
+
+#include <catch.hpp>
+
+
+TEST_CASE("HDF5Writer", "[persistency]") {
+
+  // Every benchmark measures the cost of writing a single row
+  // of one of the tables of the output file.
+  const std::string filename = "nexus_benchmark_writer.h5";
+
+  nexus::HDF5Writer writer;
+  writer.Open(filename, true);
+
+  int evt = 0;
+
+  BENCHMARK("WriteSensorDataInfo") {
+    writer.WriteSensorDataInfo(evt, 1000, 450, 3);
+  };
+
+  BENCHMARK("WriteHitInfo") {
+    writer.WriteHitInfo(evt, 1, 12, 10., -20., 300., 15., 0.01, "ACTIVE");
+  };
+
+  BENCHMARK("WriteParticleInfo") {
+    writer.WriteParticleInfo(evt, 1, "e-", 1, 0,
+                             10., -20., 300., 0.,
+                             12., -18., 310., 1.,
+                             "ACTIVE", "ACTIVE",
+                             0.1, 0.2, 2.4, 0., 0., 0.,
+                             2.458, 25., "none", "eIoni");
+  };
+
+  BENCHMARK("WriteSensorPosInfo") {
+    writer.WriteSensorPosInfo(1000, "TP_SiPM", 10., -20., 1500.);
+  };
+
+  BENCHMARK("WriteStep") {
+    writer.WriteStep(evt, 1, "e-", 12, "ACTIVE", "ACTIVE", "eIoni",
+                     10., -20., 300., 10.5, -19.5, 300.5);
+  };
+
+  writer.Close();
+  std::remove(filename.c_str());
+
+}
@@ -0,0 +1,118 @@
+#include <UniformElectricDriftField.h>
+#include <Electroluminescence.h>
+#include <IonizationElectron.h>
+#include <MaterialsList.h>
+#include <OpticalMaterialProperties.h>
+#include <XenonProperties.h>
+
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4DynamicParticle.hh>
+#include <G4VParticleChange.hh>
+#include <G4NavigationHistory.hh>
+#include <G4TouchableHistory.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4Region.hh>
+#include <G4Box.hh>
+#include <G4LorentzVector.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <vector>
+
+#include <catch.hpp>
+
+
+TEST_CASE("UniformElectricDriftField::Drift", "[physics]") {
+
+  // Drift of the ionization electrons of a typical event
+  // along the NEXT-100 drift region.
+  G4Random::setTheSeed(12345);
+
+  nexus::UniformElectricDriftField field(0., 1200.*mm, kZAxis);
+  field.SetDriftVelocity(1.*mm/microsecond);
+  field.SetLongitudinalDiffusion(0.3*mm/sqrt(cm));
+  field.SetTransverseDiffusion(1.*mm/sqrt(cm));
+
+  const G4int n_charges = 10000;
+  std::vector<G4LorentzVector> origins;
+  for (G4int i=0; i<n_charges; ++i)
+    origins.push_back(G4LorentzVector(G4RandFlat::shoot(-50.*cm, 50.*cm),
+                                      G4RandFlat::shoot(-50.*cm, 50.*cm),
+                                      G4RandFlat::shoot(0., 1200.*mm), 0.));
+
+  BENCHMARK("10k ionization electrons") {
+    G4double length = 0.;
+    for (const auto& origin: origins) {
+      G4LorentzVector xyzt(origin);
+      length += field.Drift(xyzt);
+    }
+    return length;
+  };
+
+}
+
+
+TEST_CASE("Electroluminescence::PostStepDoIt", "[physics]") {
+
+  // Generation of the EL photons of a single ionization electron
+  // crossing a NEXT-100-like EL gap.
+  G4Random::setTheSeed(12345);
+
+  const G4double pressure    = 13.5 * bar;
+  const G4double temperature = 303. * kelvin;
+  const G4double gap_length  = 10. * mm;
+
+  // The optical properties must be in place before
+  // the process builds its tables
+  G4Material* gxe = materials::GXe(pressure, temperature);
+  gxe->SetMaterialPropertiesTable(opticalprops::GXe(pressure, temperature));
+
+  auto gap_logic =
+    new G4LogicalVolume(new G4Box("BENCHMARK_EL_GAP", 1.*m, 1.*m, gap_length/2.),
+                        gxe, "BENCHMARK_EL_GAP");
+  auto gap_phys =
+    new G4PVPlacement(nullptr, G4ThreeVector(), gap_logic,
+                      "BENCHMARK_EL_GAP", nullptr, false, 0);
+
+  auto field = new nexus::UniformElectricDriftField(gap_length/2., -gap_length/2., kZAxis);
+  field->SetDriftVelocity(2.5*mm/microsecond);
+  field->SetLightYield(XenonELLightYield(16.*kilovolt/cm, pressure));
+
+  auto region = new G4Region("BENCHMARK_EL_REGION");
+  region->AddRootLogicalVolume(gap_logic);
+  gap_logic->SetRegion(region);
+  region->SetUserInformation(field);
+
+  nexus::Electroluminescence el;
+
+  G4NavigationHistory history;
+  history.SetFirstEntry(gap_phys);
+  G4TouchableHandle touchable(new G4TouchableHistory(history));
+
+  G4Track track(new G4DynamicParticle(nexus::IonizationElectron::Definition(),
+                                      G4ThreeVector(0., 0., 1.), 0.),
+                0., G4ThreeVector(0., 0., -gap_length/2.));
+  track.SetTouchableHandle(touchable);
+
+  G4Step step;
+  step.SetTrack(&track);
+  step.SetStepLength(gap_length);
+  step.GetPreStepPoint()->SetPosition(G4ThreeVector(0., 0., -gap_length/2.));
+  step.GetPreStepPoint()->SetGlobalTime(0.);
+  step.GetPreStepPoint()->SetTouchableHandle(touchable);
+  step.GetPostStepPoint()->SetPosition(G4ThreeVector(0., 0., gap_length/2.));
+  step.GetPostStepPoint()->SetGlobalTime(gap_length / (2.5*mm/microsecond));
+  step.GetPostStepPoint()->SetTouchableHandle(touchable);
+
+  BENCHMARK("photons of one ionization electron") {
+    G4VParticleChange* change = el.PostStepDoIt(track, step);
+    G4int n = change->GetNumberOfSecondaries();
+    // The secondaries would be taken over by the stepping manager
+    for (G4int i=0; i<n; ++i) delete change->GetSecondary(i);
+    change->Clear();
+    return n;
+  };
+
+}
@@ -0,0 +1,59 @@
+#include <CylinderPointSampler2020.h>
+#include <HexagonPointSampler.h>
+#include <SpherePointSampler.h>
+
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("CylinderPointSampler2020", "[utils]") {
+
+  G4Random::setTheSeed(12345);
+
+  nexus::CylinderPointSampler2020 sampler(0., 50.*cm, 60.*cm, 0., twopi);
+
+  BENCHMARK("VOLUME") {
+    return sampler.GenerateVertex("VOLUME");
+  };
+
+  BENCHMARK("OUTER_SURFACE") {
+    return sampler.GenerateVertex("OUTER_SURFACE");
+  };
+
+}
+
+
+TEST_CASE("HexagonPointSampler", "[utils]") {
+
+  G4Random::setTheSeed(12345);
+
+  nexus::HexagonPointSampler sampler(50.*cm, 120.*cm, 1.*cm);
+
+  BENCHMARK("INSIDE") {
+    return sampler.GenerateVertex(nexus::INSIDE);
+  };
+
+  BENCHMARK("PLANE") {
+    return sampler.GenerateVertex(nexus::PLANE);
+  };
+
+}
+
+
+TEST_CASE("SpherePointSampler", "[utils]") {
+
+  G4Random::setTheSeed(12345);
+
+  nexus::SpherePointSampler sampler(50.*cm, 1.*cm);
+
+  BENCHMARK("INSIDE") {
+    return sampler.GenerateVertex("INSIDE");
+  };
+
+  BENCHMARK("SURFACE") {
+    return sampler.GenerateVertex("SURFACE");
+  };
+
+}
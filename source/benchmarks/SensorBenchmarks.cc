@@ -0,0 +1,112 @@
+#include <SensorHit.h>
+#include <SensorSD.h>
+
+#include <G4SDManager.hh>
+#include <G4HCofThisEvent.hh>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4DynamicParticle.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4NavigationHistory.hh>
+#include <G4TouchableHistory.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVPlacement.hh>
+#include <G4Box.hh>
+#include <G4NistManager.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <memory>
+#include <vector>
+
+#include <catch.hpp>
+
+
+TEST_CASE("SensorHit::Fill", "[sensdet]") {
+
+  // Time of arrival of the photons of a typical S2 signal,
+  // spread over a few tens of microseconds.
+  G4Random::setTheSeed(12345);
+
+  const G4int n_photons = 10000;
+  std::vector<G4double> times(n_photons);
+  for (auto& t: times) t = G4RandGauss::shoot(500.*microsecond, 10.*microsecond);
+
+  BENCHMARK("10k photons, 1 mus bins") {
+    nexus::SensorHit hit(0, G4ThreeVector(), 1.*microsecond);
+    for (auto t: times) hit.Fill(t);
+    return hit.GetHistogram().size();
+  };
+
+  BENCHMARK("10k photons, 25 ns bins") {
+    nexus::SensorHit hit(0, G4ThreeVector(), 25.*nanosecond);
+    for (auto t: times) hit.Fill(t);
+    return hit.GetHistogram().size();
+  };
+
+}
+
+
+TEST_CASE("SensorSD::ProcessHits", "[sensdet]") {
+
+  // This benchmark measures the cost of finding (or creating) the hit
+  // associated to a sensor for every detected photon, with a number of
+  // sensors similar to that of the NEXT-100 tracking plane.
+  G4Random::setTheSeed(12345);
+
+  const G4int n_sensors = 3500;
+  const G4int n_photons = 10000;
+
+  G4Material* air = G4NistManager::Instance()->FindOrBuildMaterial("G4_AIR");
+
+  auto board_logic =
+    new G4LogicalVolume(new G4Box("BENCHMARK_BOARD", 1.*m, 1.*m, 1.*cm),
+                        air, "BENCHMARK_BOARD");
+  auto board_phys =
+    new G4PVPlacement(nullptr, G4ThreeVector(), board_logic,
+                      "BENCHMARK_BOARD", nullptr, false, 0);
+
+  auto sensor_logic =
+    new G4LogicalVolume(new G4Box("BENCHMARK_SENSOR", 1.*mm, 1.*mm, 1.*mm),
+                        air, "BENCHMARK_SENSOR");
+  auto sensor_phys =
+    new G4PVPlacement(nullptr, G4ThreeVector(), sensor_logic,
+                      "BENCHMARK_SENSOR", board_logic, false, 0);
+
+  // One touchable per sensor, differing only in the copy number
+  std::vector<G4TouchableHandle> touchables;
+  for (G4int i=0; i<n_sensors; ++i) {
+    G4NavigationHistory history;
+    history.SetFirstEntry(board_phys);
+    history.NewLevel(sensor_phys, kNormal, i);
+    touchables.push_back(G4TouchableHandle(new G4TouchableHistory(history)));
+  }
+
+  G4Track track(new G4DynamicParticle(G4OpticalPhoton::Definition(),
+                                      G4ThreeVector(0., 0., 1.), 7.*eV),
+                0., G4ThreeVector());
+
+  std::vector<std::unique_ptr<G4Step>> steps;
+  for (G4int i=0; i<n_photons; ++i) {
+    auto step = std::make_unique<G4Step>();
+    step->SetTrack(&track);
+    G4StepPoint* point = step->GetPostStepPoint();
+    point->SetTouchableHandle(touchables[G4RandFlat::shootInt(n_sensors)]);
+    point->SetGlobalTime(G4RandGauss::shoot(500.*microsecond, 10.*microsecond));
+    steps.push_back(std::move(step));
+  }
+
+  auto sd = new nexus::SensorSD("/BENCHMARK/SENSOR");
+  sd->SetDetectorVolumeDepth(0);
+  sd->SetTimeBinning(1.*microsecond);
+  G4SDManager::GetSDMpointer()->AddNewDetector(sd);
+  const G4int capacity = G4SDManager::GetSDMpointer()->GetCollectionCapacity();
+
+  BENCHMARK("10k photons on 3500 sensors") {
+    G4HCofThisEvent hce(capacity);
+    sd->Initialize(&hce);
+    for (auto& step: steps) sd->Hit(step.get());
+    return hce.GetNumberOfCollections();
+  };
+
+}
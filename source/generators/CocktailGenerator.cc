@@ -0,0 +1,155 @@
+// ----------------------------------------------------------------------------
+// nexus | CocktailGenerator.cc
+//
+// This class is a primary generator that combines several other
+// generators, each one with its own rate. Every event contains either
+// one decay of a component chosen according to the rates or, in
+// overlay mode, all the decays of all the components that fall within
+// a time window. Components reading their events from a file can
+// only be skipped (shards) if they read one of them per event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "CocktailGenerator.h"
+
+#include "FactoryBase.h"
+#include "PrimaryVertexUtils.h"
+
+#include <G4Event.hh>
+#include <G4GenericMessenger.hh>
+#include <G4Poisson.hh>
+#include <Randomize.hh>
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+using namespace nexus;
+using namespace CLHEP;
+
+REGISTER_CLASS(CocktailGenerator, G4VPrimaryGenerator)
+
+
+CocktailGenerator::CocktailGenerator():
+  G4VPrimaryGenerator(), msg_(0), overlay_(false), time_window_(1.*ms),
+  rates_changed_(true)
+{
+  msg_ = new G4GenericMessenger(this, "/Generator/CocktailGenerator/",
+				"Control commands of the cocktail generator.");
+
+  msg_->DeclareMethod("add", &CocktailGenerator::AddGenerator,
+                      "Add a component to the cocktail. Its parameters are "
+                      "set with the commands of the generator itself.");
+
+  G4GenericMessenger::Command& rate_cmd =
+    msg_->DeclareMethodWithUnit("rate", "Hz", &CocktailGenerator::SetRate,
+                                "Set the rate of the last component added.");
+  rate_cmd.SetParameterName("rate", false);
+  rate_cmd.SetRange("rate>=0.");
+
+  msg_->DeclareProperty("overlay", overlay_,
+                        "Overlay all the decays within the time window "
+                        "instead of one decay per event.");
+
+  G4GenericMessenger::Command& window_cmd =
+    msg_->DeclarePropertyWithUnit("time_window", "ms", time_window_,
+                                  "Length of the time window (overlay mode).");
+  window_cmd.SetParameterName("time_window", false);
+  window_cmd.SetRange("time_window>0.");
+}
+
+
+
+CocktailGenerator::~CocktailGenerator()
+{
+  delete msg_;
+}
+
+
+
+void CocktailGenerator::AddGenerator(G4String name)
+{
+  // Each generator type has a single set of commands,
+  // so it cannot appear twice in the cocktail
+  for (const auto& n: names_) {
+    if (n == name) {
+      G4String msg = "Generator " + name + " is already part of the cocktail.";
+      G4Exception("[CocktailGenerator]", "AddGenerator()", FatalException, msg);
+    }
+  }
+
+  generators_.push_back(ObjFactory<G4VPrimaryGenerator>::Instance().CreateObject(name));
+  names_.push_back(name);
+  rates_.push_back(1.*hertz);
+  rates_changed_ = true;
+}
+
+
+
+void CocktailGenerator::SetRate(G4double rate)
+{
+  if (rates_.empty())
+    G4Exception("[CocktailGenerator]", "SetRate()", FatalException,
+                "No component has been added to the cocktail yet.");
+
+  rates_.back() = rate;
+  rates_changed_ = true;
+}
+
+
+
+void CocktailGenerator::GeneratePrimaryVertex(G4Event* event)
+{
+  if (generators_.empty())
+    G4Exception("[CocktailGenerator]", "GeneratePrimaryVertex()",
+                FatalException, "The cocktail has no components!");
+
+  if (rates_changed_) {
+    rate_table_.Build(rates_.data(), rates_.size());
+    rates_changed_ = false;
+  }
+
+  // The component that triggers the event starts at t=0
+  GenerateDelayedVertices(*generators_[rate_table_.Sample()], event, 0.);
+
+  if (!overlay_) return;
+
+  // Add the decays of every component that fall within the window
+  for (size_t i=0; i<generators_.size(); ++i) {
+    G4long n = G4Poisson(rates_[i] * time_window_);
+    for (G4long k=0; k<n; ++k)
+      GenerateDelayedVertices(*generators_[i], event, G4UniformRand() * time_window_);
+  }
+}
+
+
+
+void CocktailGenerator::SetEventOffset(G4int n)
+{
+  if (!ReadsInputFile()) return;
+
+  // With several components or in overlay mode, each event reads a
+  // random number of the events of the input files
+  if ((overlay_ || generators_.size() > 1) && n > 0)
+    G4Exception("[CocktailGenerator]", "SetEventOffset()", FatalException,
+                "Cannot skip the events of an input file read by a cocktail "
+                "with several components or in overlay mode.");
+
+  for (auto& generator: generators_) {
+    SequentialGenerator* sequential =
+      dynamic_cast<SequentialGenerator*>(generator.get());
+    if (sequential && sequential->ReadsInputFile())
+      sequential->SetEventOffset(n);
+  }
+}
+
+
+
+G4bool CocktailGenerator::ReadsInputFile() const
+{
+  for (const auto& generator: generators_) {
+    const SequentialGenerator* sequential =
+      dynamic_cast<const SequentialGenerator*>(generator.get());
+    if (sequential && sequential->ReadsInputFile()) return true;
+  }
+  return false;
+}
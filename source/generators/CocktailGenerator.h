@@ -0,0 +1,72 @@
+// ----------------------------------------------------------------------------
+// nexus | CocktailGenerator.h
+//
+// This class is a primary generator that combines several other
+// generators, each one with its own rate. Every event contains either
+// one decay of a component chosen according to the rates or, in
+// overlay mode, all the decays of all the components that fall within
+// a time window. Components reading their events from a file can
+// only be skipped (shards) if they read one of them per event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef COCKTAIL_GENERATOR_H
+#define COCKTAIL_GENERATOR_H
+
+#include "AliasTable.h"
+#include "SequentialGenerator.h"
+
+#include <G4VPrimaryGenerator.hh>
+
+#include <memory>
+#include <vector>
+
+class G4Event;
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  class CocktailGenerator: public G4VPrimaryGenerator, public SequentialGenerator
+  {
+  public:
+    /// Constructor
+    CocktailGenerator();
+    /// Destructor
+    ~CocktailGenerator();
+
+    /// This method is invoked at the beginning of the event. It asks
+    /// one or several of the components to add their primary vertices
+    /// to the event.
+    void GeneratePrimaryVertex(G4Event*);
+
+    /// Forward the offset to the components reading an input file
+    void SetEventOffset(G4int);
+    /// Is any of the components reading an input file?
+    G4bool ReadsInputFile() const;
+
+  private:
+    /// Create a new component with the generator registered under
+    /// the given name. Its rate is set with SetRate.
+    void AddGenerator(G4String name);
+    /// Set the rate of the last component added
+    void SetRate(G4double rate);
+
+  private:
+    G4GenericMessenger* msg_;
+
+    std::vector<std::unique_ptr<G4VPrimaryGenerator>> generators_; ///< Components of the cocktail
+    std::vector<G4String> names_; ///< Generator names of the components
+    std::vector<G4double> rates_; ///< Rate of each component
+
+    G4bool overlay_;       ///< Overlay all decays within the time window?
+    G4double time_window_; ///< Length of the acquisition window (overlay mode)
+
+    AliasTable rate_table_; ///< Component selection according to the rates
+    G4bool rates_changed_;  ///< Does the selection table need rebuilding?
+  };
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,283 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0File.cc
+//
+// This class reads the binary version of the event files produced by
+// Decay0 (.genbb), which is created with the nexus-decay0-convert tool.
+// The file is memory-mapped, so that reading an event does not involve
+// any parsing and any event can be reached directly.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Decay0File.h"
+#include "CacheFile.h"
+
+#include <G4Exception.hh>
+#include <G4ios.hh>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+  // Layout of the file:
+  //   FileHeader | text header (padded to 8 bytes) | events | particles
+  const char     kMagic[4] = {'N', 'D', '0', 'B'};
+  const uint32_t kVersion  = 1;
+
+  struct FileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t n_events;
+    uint64_t n_particles;
+    uint64_t header_size;
+    uint64_t events_offset;
+    uint64_t particles_offset;
+  };
+
+}
+
+
+namespace nexus {
+
+
+  Decay0File::Decay0File():
+    fd_(-1), size_(0), data_(nullptr), n_events_(0),
+    events_(nullptr), particles_(nullptr), header_(nullptr),
+    header_size_(0), next_(0)
+  {
+  }
+
+
+
+  Decay0File::~Decay0File()
+  {
+    Close();
+  }
+
+
+
+  G4bool Decay0File::Open(const G4String& filename)
+  {
+    Close();
+
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) return false;
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || size_t(st.st_size) < sizeof(FileHeader)) {
+      Close();
+      return false;
+    }
+    size_ = st.st_size;
+
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+      Close();
+      return false;
+    }
+    data_ = static_cast<const char*>(addr);
+    // Events are read in order, so let the kernel read ahead
+    madvise(addr, size_, MADV_SEQUENTIAL);
+
+    FileHeader hdr;
+    std::memcpy(&hdr, data_, sizeof(hdr));
+
+    // Sections must follow each other within the file, aligned to
+    // 8 bytes (the sizes are compared so that they cannot overflow)
+    G4bool valid =
+      std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) == 0 &&
+      hdr.version == kVersion &&
+      hdr.header_size <= size_ - sizeof(FileHeader) &&
+      sizeof(FileHeader) + hdr.header_size <= hdr.events_offset &&
+      hdr.events_offset % 8 == 0 && hdr.events_offset <= size_ &&
+      hdr.n_events <= (size_ - hdr.events_offset) / sizeof(Decay0EventRecord) &&
+      hdr.events_offset + hdr.n_events * sizeof(Decay0EventRecord) <= hdr.particles_offset &&
+      hdr.particles_offset % 8 == 0 && hdr.particles_offset <= size_ &&
+      hdr.n_particles <= (size_ - hdr.particles_offset) / sizeof(Decay0ParticleRecord);
+
+    // The particles of every event must be in the file
+    if (valid) {
+      const Decay0EventRecord* events =
+        reinterpret_cast<const Decay0EventRecord*>(data_ + hdr.events_offset);
+      for (uint64_t i=0; i<hdr.n_events && valid; ++i)
+        valid = events[i].first <= hdr.n_particles &&
+                events[i].entries <= hdr.n_particles - events[i].first;
+    }
+
+    if (!valid) {
+      G4String msg = "File " + filename + " is not a valid binary Decay0 file.";
+      G4Exception("[Decay0File]", "Open()", JustWarning, msg);
+      Close();
+      return false;
+    }
+
+    n_events_    = hdr.n_events;
+    header_      = data_ + sizeof(FileHeader);
+    header_size_ = hdr.header_size;
+    events_      = reinterpret_cast<const Decay0EventRecord*>(data_ + hdr.events_offset);
+    particles_   = reinterpret_cast<const Decay0ParticleRecord*>(data_ + hdr.particles_offset);
+    next_        = 0;
+
+    return true;
+  }
+
+
+
+  void Decay0File::Close()
+  {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    if (fd_ >= 0) close(fd_);
+
+    fd_ = -1;
+    size_ = 0;
+    data_ = nullptr;
+    n_events_ = 0;
+    events_ = nullptr;
+    particles_ = nullptr;
+    header_ = nullptr;
+    header_size_ = 0;
+    next_ = 0;
+  }
+
+
+
+  G4String Decay0File::GetHeader() const
+  {
+    if (!header_) return "";
+    return G4String(std::string(header_, header_size_));
+  }
+
+
+
+  void Decay0File::SkipTo(uint64_t k)
+  {
+    if (k > n_events_) {
+      G4Exception("[Decay0File]", "SkipTo()", JustWarning,
+                  "Requested event is beyond the end of the file.");
+      k = n_events_;
+    }
+    next_ = k;
+  }
+
+
+
+  const Decay0EventRecord* Decay0File::ReadEvent()
+  {
+    if (next_ >= n_events_) return nullptr;
+    return &events_[next_++];
+  }
+
+
+
+  G4bool Decay0File::IsBinary(const G4String& filename)
+  {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    return in.good() && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  }
+
+
+
+  uint64_t Decay0File::Convert(const G4String& genbb, const G4String& binary)
+  {
+    std::ifstream in(genbb.c_str());
+    if (!in.good()) {
+      G4String msg = "Cannot open Decay0 input file " + genbb;
+      G4Exception("[Decay0File]", "Convert()", FatalException, msg);
+    }
+
+    // The text header ends two lines after the "First event" line
+    std::string header, line;
+    while (std::getline(in, line)) {
+      header += line + "\n";
+      if (line.find("First event") != std::string::npos) break;
+    }
+    for (G4int i=0; i<2 && std::getline(in, line); ++i) header += line + "\n";
+
+    std::vector<Decay0EventRecord> events;
+    std::vector<Decay0ParticleRecord> particles;
+
+    Decay0EventRecord evt;
+    while (in >> evt.number >> evt.time >> evt.entries) {
+      evt.first   = particles.size();
+      evt.padding = 0;
+      for (uint32_t i=0; i<evt.entries; ++i) {
+        G4int g3code;
+        Decay0ParticleRecord part;
+        in >> g3code >> part.px >> part.py >> part.pz >> part.time;
+        if (!in) {
+          G4String msg = "Truncated event in Decay0 input file " + genbb;
+          G4Exception("[Decay0File]", "Convert()", FatalException, msg);
+        }
+        part.pdg = G3toPDG(g3code);
+        part.padding = 0;
+        particles.push_back(part);
+      }
+      events.push_back(evt);
+    }
+
+    FileHeader hdr;
+    std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+    hdr.version          = kVersion;
+    hdr.n_events         = events.size();
+    hdr.n_particles      = particles.size();
+    hdr.header_size      = header.size();
+    hdr.events_offset    = (sizeof(FileHeader) + header.size() + 7) / 8 * 8;
+    hdr.particles_offset = hdr.events_offset + events.size() * sizeof(Decay0EventRecord);
+
+    // Jobs reading the binary file never see it half written
+    const G4bool written = WriteAtomically(binary, [&](const std::string& tmp_name) {
+      std::ofstream out(tmp_name, std::ios::binary);
+      out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+      out.write(header.data(), header.size());
+      const std::string padding(hdr.events_offset - sizeof(hdr) - header.size(), '\0');
+      out.write(padding.data(), padding.size());
+      out.write(reinterpret_cast<const char*>(events.data()),
+                events.size() * sizeof(Decay0EventRecord));
+      out.write(reinterpret_cast<const char*>(particles.data()),
+                particles.size() * sizeof(Decay0ParticleRecord));
+      out.close();
+      return G4bool(out);
+    });
+
+    if (!written) {
+      G4String msg = "Error writing binary Decay0 file " + binary;
+      G4Exception("[Decay0File]", "Convert()", FatalException, msg);
+    }
+
+    return events.size();
+  }
+
+
+
+  G4int Decay0File::G3toPDG(const G4int G3code)
+  {
+    int pdg_code = 0;
+    if      (G3code == 1) pdg_code =  22;         // gamma
+    else if (G3code == 2)  pdg_code = -11;         // e+
+    else if (G3code == 3) pdg_code =   11;         // e-
+    else if (G3code == 5) pdg_code =  -13;         // mu+
+    else if (G3code == 6) pdg_code =  13;          // mu-
+    else if (G3code == 13) pdg_code =  2112;       // neutron
+    else if (G3code == 14) pdg_code =  2212;       // proton
+    else if (G3code == 47) pdg_code =  1000020040; // alpha
+    else {
+      G4cerr << "[Decay0File] ERROR: Particle with unknown GEANT3 code: "
+             << G3code << G4endl;
+      G4Exception("[Decay0File]", "G3toPDG()", FatalException,
+                  "Unknown particle GEANT3 code!");
+    }
+    return pdg_code;
+  }
+
+} // namespace nexus
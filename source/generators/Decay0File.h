@@ -0,0 +1,108 @@
+// ----------------------------------------------------------------------------
+// nexus | Decay0File.h
+//
+// This class reads the binary version of the event files produced by
+// Decay0 (.genbb), which is created with the nexus-decay0-convert tool.
+// The file is memory-mapped, so that reading an event does not involve
+// any parsing and any event can be reached directly.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DECAY0_FILE_H
+#define DECAY0_FILE_H
+
+#include <G4String.hh>
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace nexus {
+
+  /// Event record of the binary file
+  struct Decay0EventRecord {
+    int64_t  number;   ///< Event number in the original file
+    double   time;     ///< Time of event's start (s)
+    uint64_t first;    ///< Index of the first particle of the event
+    uint32_t entries;  ///< Number of particles in the event
+    uint32_t padding;
+  };
+
+  /// Particle record of the binary file
+  struct Decay0ParticleRecord {
+    int32_t pdg;       ///< PDG code (already translated from GEANT3)
+    int32_t padding;
+    double  px, py, pz; ///< Momentum components (MeV/c)
+    double  time;      ///< Time shift from previous particle (s)
+  };
+
+
+  class Decay0File
+  {
+  public:
+    /// Constructor
+    Decay0File();
+    /// Destructor
+    ~Decay0File();
+
+    /// Map the given binary file into memory. Returns false if it
+    /// cannot be opened or it is not a valid binary Decay0 file.
+    G4bool Open(const G4String& filename);
+    /// Unmap the file
+    void Close();
+
+    G4bool IsOpen() const;
+
+    /// Total number of events in the file
+    uint64_t GetNumberOfEvents() const;
+    /// Text header of the original .genbb file
+    G4String GetHeader() const;
+
+    /// Position the reader so that the next event read is event k
+    /// (counted from 0), without reading the events before it
+    void SkipTo(uint64_t k);
+    /// Index of the next event to be read
+    uint64_t GetNextEvent() const;
+
+    /// Return the next event record and advance the reader, or a null
+    /// pointer if the end of the file was reached
+    const Decay0EventRecord* ReadEvent();
+    /// Particle records of the given event
+    const Decay0ParticleRecord* GetParticles(const Decay0EventRecord*) const;
+
+    /// Returns true if the file starts with the binary Decay0 signature
+    static G4bool IsBinary(const G4String& filename);
+    /// Convert a .genbb text file into the binary format.
+    /// Returns the number of events converted.
+    static uint64_t Convert(const G4String& genbb, const G4String& binary);
+    /// Return the PDG code equivalent to a given GEANT3 particle code
+    static G4int G3toPDG(G4int);
+
+  private:
+    int fd_;            ///< File descriptor
+    size_t size_;       ///< Size of the mapped file
+    const char* data_;  ///< Start of the mapped file
+
+    uint64_t n_events_;
+    const Decay0EventRecord* events_;
+    const Decay0ParticleRecord* particles_;
+    const char* header_;
+    uint64_t header_size_;
+
+    uint64_t next_; ///< Index of the next event to be read
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool Decay0File::IsOpen() const { return data_ != nullptr; }
+  inline uint64_t Decay0File::GetNumberOfEvents() const { return n_events_; }
+  inline uint64_t Decay0File::GetNextEvent() const { return next_; }
+
+  inline const Decay0ParticleRecord*
+  Decay0File::GetParticles(const Decay0EventRecord* evt) const
+  { return particles_ + evt->first; }
+
+} // namespace nexus
+
+#endif
@@ -6,7 +6,8 @@
 // FORTRAN package, with nexus.
 // It provides the primary vertex of a Xe-136 double beta decay.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta is also allowed, as well as its binary version
+// (see Decay0File), which is much faster to read.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -29,7 +30,8 @@ REGISTER_CLASS(Decay0Interface, G4VPrimaryGenerator)
 
 
 Decay0Interface::Decay0Interface():
-  G4VPrimaryGenerator(), msg_(0), opened_(false), geom_(0)
+  G4VPrimaryGenerator(), msg_(0), binary_(false), first_event_(0),
+  event_offset_(0), skipped_(false), opened_(false), geom_(0)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/Decay0Interface/",
@@ -37,10 +39,14 @@ Decay0Interface::Decay0Interface():
 
   msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile, "");
   msg_->DeclareProperty("region", region_, "");
+  msg_->DeclareMethod("firstEvent", &Decay0Interface::SetFirstEvent,
+                      "First event of the input file to be simulated (counted from 0).");
 
   msg_->DeclareMethod("EnergyThreshold", &Decay0Interface::SetEnergyThreshold, ""); // for electrons only.
   msg_->DeclareMethod("Xe136DecayMode", &Decay0Interface::SetXe136DecayMode, "");
   msg_->DeclareMethod("Ba136FinalState", &Decay0Interface::SetBa136FinalState, "");
+  msg_->DeclareProperty("TableCacheDir", tableCacheDir_,
+                        "Directory where the tabulated energy spectrum of the electrons is cached.");
 
   DetectorConstruction* detConst = (DetectorConstruction*)
   G4RunManager::GetRunManager()->GetUserDetectorConstruction();
@@ -70,6 +76,18 @@ void Decay0Interface::OpenInputFile(G4String filename)
      return;
    }
 
+  if (Decay0File::IsBinary(filename)) {
+    if (binary_file_.Open(filename)) {
+      opened_ = true;
+      binary_ = true;
+      binary_file_.SkipTo(first_event_ + event_offset_);
+      return;
+    }
+    G4Exception("[Decay0Interface]", "SetInputFile()", JustWarning,
+      "Cannot open binary Decay0 input file.");
+    return;
+  }
+
   file_.open(filename.data());
 
   if (file_.good()) {
@@ -88,12 +106,16 @@ void Decay0Interface::OpenInputFile(G4String filename)
 /// vertices accordingly
 void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 {
+  G4ThreeVector particle_position;
+  G4double particle_time = 0.;
+
   const bool runG4 = true;
 //  const bool runG4 = false;
   if (!opened_) {
      if (decay0_ == 0) {
        const std::string XeName("Xe136");
-       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_);
+       decay0_ = new decay0(XeName, Ba136FinalState_, Xe136DecayMode_,
+                            0.0, 4.3, tableCacheDir_);
       // Temporary debugging file, just generate particle and dump them on a file
 //      std::ostringstream fOutStrStr; fOutStrStr << "./Decay0Out_" << Ba136FinalState_ << "_" << Xe136DecayMode_ << "_V1.txt";
 //      std::string fOutStr(fOutStrStr.str());
@@ -124,8 +146,7 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
      if (runG4 && keepEvt) {
         particle_position = geom_->GenerateVertex(region_);
         for (std::vector<decay0Part>::const_iterator itp = theParts.begin(); itp != theParts.end(); itp++) {
-          G4ParticleDefinition* g4code =
-             G4ParticleTable::GetParticleTable()->FindParticle(itp->pdgCode_);
+          G4ParticleDefinition* g4code = FindParticle(itp->pdgCode_);
           G4PrimaryParticle* particle =
 	     new G4PrimaryParticle(g4code, MeV*itp->pmom_[0], MeV*itp->pmom_[1], MeV*itp->pmom_[2]);
          // create a primary vertex for the particle
@@ -140,6 +161,38 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
   //G4cout << "GeneratePrimaryVertex()" << G4endl;
 
+  if (binary_) {
+    const Decay0EventRecord* evt = binary_file_.ReadEvent();
+
+    // abort if the end of the file was reached
+    if (!evt) {
+      G4cout  << "[Decay0Interface] End-of-File reached. "
+              << "Aborting the run..." << G4endl;
+      G4RunManager::GetRunManager()->AbortRun();
+      return;
+    }
+
+    particle_position = geom_->GenerateVertex(region_);
+
+    const Decay0ParticleRecord* parts = binary_file_.GetParticles(evt);
+    for (uint32_t i=0; i<evt->entries; i++) {
+      G4ParticleDefinition* g4code = FindParticle(parts[i].pdg);
+
+      G4PrimaryParticle* particle =
+        new G4PrimaryParticle(g4code, parts[i].px*MeV, parts[i].py*MeV, parts[i].pz*MeV);
+      particle->SetMass(g4code->GetPDGMass());
+      particle->SetCharge(g4code->GetPDGCharge());
+
+      G4PrimaryVertex* vertex =
+        new G4PrimaryVertex(particle_position, parts[i].time*second);
+      vertex->SetPrimary(particle);
+      event->AddPrimaryVertex(vertex);
+    }
+    return;
+  }
+
+  if (!skipped_) SkipTextEvents();
+
   // reading event-related information
   G4int entries;     // number of particles in the event
   G4long evt_no;     // event number
@@ -172,8 +225,7 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
     file_ >> g3code >> px >> py >> pz >> particle_time;
 
-    G4ParticleDefinition* g4code =
-      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(g3code));
+    G4ParticleDefinition* g4code = FindParticle(Decay0File::G3toPDG(g3code));
 
     // create a primary particle
     G4PrimaryParticle* particle =
@@ -207,23 +259,65 @@ void Decay0Interface::ProcessHeader()
 
 
 
-G4int Decay0Interface::G3toPDG(const G4int G3code)
+void Decay0Interface::SetFirstEvent(G4int k)
 {
-  int pdg_code = 0;
-  if      (G3code == 1) pdg_code =  22;         // gamma
-  else if (G3code == 2)  pdg_code = -11;         // e+
-  else if (G3code == 3) pdg_code =   11;         // e-
-  else if (G3code == 5) pdg_code =  -13;         // mu+
-  else if (G3code == 6) pdg_code =  13;          // mu-
-  else if (G3code == 13) pdg_code =  2112;       // neutron
-  else if (G3code == 14) pdg_code =  2212;       // proton
-  else if (G3code == 47) pdg_code =  1000020040; // alpha
-  else {
-    G4cerr << "[Decay0Interface] ERROR: Particle with unknown GEANT3 code: "
-    << G3code << G4endl;
-     G4Exception("[Decay0Interface]", "G3toPDG()", FatalException,
-		 "Unknown particle GEANT3 code!");
-  //G4Exception("Aborting run...");
+  if (k < 0) {
+    G4Exception("[Decay0Interface]", "SetFirstEvent()", JustWarning,
+      "The first event must be a non-negative number.");
+    return;
   }
-  return pdg_code;
+
+  first_event_ = k;
+  if (binary_) binary_file_.SkipTo(first_event_ + event_offset_);
+}
+
+
+
+void Decay0Interface::SetEventOffset(G4int n)
+{
+  // The ascii file cannot be rewound once its events are being read
+  if (opened_ && !binary_ && skipped_ && n != event_offset_)
+    G4Exception("[Decay0Interface]", "SetEventOffset()", FatalException,
+                "The events of the Decay0 input file are already being read.");
+
+  event_offset_ = n;
+  if (binary_) binary_file_.SkipTo(first_event_ + event_offset_);
+}
+
+
+
+void Decay0Interface::SkipTextEvents()
+{
+  // Events have to be parsed one by one in the ascii file,
+  // which is why the binary format is preferred for this
+  skipped_ = true;
+
+  G4String line;
+  for (G4int k=0; k<first_event_+event_offset_; k++) {
+    G4long evt_no;
+    G4double evt_time;
+    G4int entries;
+    file_ >> evt_no >> evt_time >> entries;
+    getline(file_, line);
+    for (G4int i=0; i<entries; i++) getline(file_, line);
+    if (file_.eof()) return;
+  }
+}
+
+
+
+G4ParticleDefinition* Decay0Interface::FindParticle(G4int pdg)
+{
+  auto it = particle_cache_.find(pdg);
+  if (it != particle_cache_.end()) return it->second;
+
+  G4ParticleDefinition* pdef =
+    G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+  if (!pdef) {
+    G4String msg = "Unknown particle with PDG code " + std::to_string(pdg);
+    G4Exception("[Decay0Interface]", "FindParticle()", FatalException, msg);
+  }
+
+  particle_cache_[pdg] = pdef;
+  return pdef;
 }
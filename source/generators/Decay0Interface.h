@@ -5,7 +5,8 @@
 // interfacing the DECAY0 c++ code, translated from the original
 // FORTRAN package, with nexus.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta is also allowed, as well as its binary version
+// (see Decay0File), which is much faster to read.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,12 +14,17 @@
 #ifndef DECAY0_INTERFACE_H
 #define DECAY0_INTERFACE_H
 
+#include "Decay0File.h"
+#include "SequentialGenerator.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <fstream>
+#include <map>
 
 class G4GenericMessenger;
 class G4Event;
 class G4PrimaryParticle;
+class G4ParticleDefinition;
 class decay0;
 
 namespace nexus {
@@ -30,7 +36,7 @@ namespace nexus {
   /// information read from an ascii file produced by the Decay0
   /// Monte-Carlo event generator.
 
-  class Decay0Interface : public G4VPrimaryGenerator
+  class Decay0Interface : public G4VPrimaryGenerator, public SequentialGenerator
   {
   public:
     /// Constructor
@@ -42,19 +48,36 @@ namespace nexus {
     /// and primary vertices accordingly
     void GeneratePrimaryVertex(G4Event*);
 
+    /// Skip this number of events of the input file,
+    /// on top of the first event set by the user
+    void SetEventOffset(G4int);
+    /// False when the events are generated by DECAY0 itself
+    G4bool ReadsInputFile() const { return opened_; }
+
   private:
     /// Open the Decay0 input file selected by the user
     void OpenInputFile(G4String);
     /// Parse information in the file header
     void ProcessHeader();
+    /// Set the first event of the file to be simulated (counted from 0)
+    void SetFirstEvent(G4int);
+    /// Skip events of the ascii file until the first one requested
+    void SkipTextEvents();
 
-    /// Return the PDG code equivalent to a given GEANT3 particle code
-    G4int G3toPDG(const G4int);
+    /// Return the particle definition of a given PDG code,
+    /// caching it to avoid looking it up in every event
+    G4ParticleDefinition* FindParticle(G4int pdg);
 
   private:
     G4GenericMessenger* msg_;
 
     std::ifstream file_; ///< ASCII file produced by Decay0
+    Decay0File binary_file_; ///< Binary version of the Decay0 file
+    G4bool binary_; ///< Is the input file binary?
+    G4int first_event_; ///< First event of the input file to be simulated
+    G4int event_offset_; ///< Events skipped on top of first_event_ (shards)
+    G4bool skipped_; ///< Have the events before first_event_ been skipped?
+    std::map<G4int, G4ParticleDefinition*> particle_cache_;
     G4String region_; ///< region of generation of vertices in geometry
 
     G4bool opened_;
@@ -69,6 +92,8 @@ namespace nexus {
 
     double energyThreshold_;
 
+    G4String tableCacheDir_; // directory where decay0 caches its tabulated spectra
+
     std::ofstream fOutDebug_; // for debugging...
     const GeometryBase* geom_;
 
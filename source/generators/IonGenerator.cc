@@ -4,6 +4,8 @@
 // This class is the primary generator for events consisting in the decay
 // of a radioactive ion. The user must specify via configuration parameters
 // the atomic number, mass number and energy level of the isotope of interest.
+// Optionally, the members of the decay chain of the ion are generated as
+// separate decays, weighted by their activity in secular equilibrium.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -19,6 +21,12 @@
 #include <G4ParticleDefinition.hh>
 #include <G4IonTable.hh>
 #include <G4PrimaryVertex.hh>
+#include <G4ProcessTable.hh>
+#include <G4RadioactiveDecay.hh>
+#include <G4DecayTable.hh>
+#include <G4VDecayChannel.hh>
+
+#include <sstream>
 
 using namespace nexus;
 
@@ -29,7 +37,9 @@ IonGenerator::IonGenerator():
   atomic_number_(0), mass_number_(0), energy_level_(0.),
   decay_at_time_zero_(true),
   region_(""),
-  msg_(nullptr), geom_(nullptr)
+  msg_(nullptr), geom_(nullptr),
+  ion_(nullptr), ion_z_(0), ion_a_(0), ion_level_(0.), ion_t0_(true),
+  decay_chain_(false), chain_max_lifetime_(365.25*24.*3600.*s), chain_built_(false)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/IonGenerator/",
                                 "Control commands of the ion gun primary generator.");
@@ -56,6 +66,20 @@ IonGenerator::IonGenerator():
   msg_->DeclareProperty("region", region_,
                         "Region of the geometry where vertices will be generated.");
 
+  msg_->DeclareProperty("decay_chain", decay_chain_,
+                        "Generate the members of the decay chain of the ion "
+                        "as separate decays.");
+
+  G4GenericMessenger::Command& chain_lifetime_cmd =
+    msg_->DeclareMethodWithUnit("chain_max_lifetime", "s", &IonGenerator::SetChainMaxLifetime,
+                                "Descendants with a longer lifetime end the decay chain.");
+  chain_lifetime_cmd.SetParameterName("chain_max_lifetime", false);
+  chain_lifetime_cmd.SetRange("chain_max_lifetime > 0");
+
+  msg_->DeclareMethod("chain_weight", &IonGenerator::SetChainWeight,
+                      "Decays of a chain member per decay of the parent "
+                      "(Z A weight), instead of secular equilibrium.");
+
   // Load the detector geometry, which will be used for the generation of vertices
   const DetectorConstruction* detconst = dynamic_cast<const DetectorConstruction*>
     (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
@@ -66,6 +90,7 @@ IonGenerator::IonGenerator():
 
 IonGenerator::~IonGenerator()
 {
+  RestoreLifetimes();
   delete msg_;
 }
 
@@ -85,18 +110,191 @@ G4ParticleDefinition* IonGenerator::IonDefinition()
   // for the correct simulation of the ionization drift and photon tracing.
   // To prevent this behaviour, the lifetime of unstable isotopes is reset here
   // (unless the configuration variable 'decay_at_time_zero' has been set to false)
-  // to an arbitrary, short value (1 ps).
+  // to an arbitrary, short value (1 ps). The definition is shared by the
+  // whole application, so its original lifetime is saved the first time
+  // and given back when the option is off or the ion changes.
+  if (lifetimes_.find(pdef) == lifetimes_.end())
+    lifetimes_[pdef] = pdef->GetPDGLifeTime();
+
   if (decay_at_time_zero_ && !(pdef->GetPDGStable())) pdef->SetPDGLifeTime(1.*ps);
+  else pdef->SetPDGLifeTime(lifetimes_[pdef]);
 
   return pdef;
 }
 
 
+void IonGenerator::SetChainWeight(G4String params)
+{
+  std::istringstream iss(params);
+  G4int z, a;
+  G4double weight;
+  if (!(iss >> z >> a >> weight) || weight < 0.)
+    G4Exception("[IonGenerator]", "SetChainWeight()", FatalException,
+                "Expected the atomic number, mass number and weight of a chain member.");
+
+  user_weights_[std::make_pair(z, a)] = weight;
+  chain_built_ = false;
+}
+
+
+void IonGenerator::SetChainMaxLifetime(G4double lifetime)
+{
+  chain_max_lifetime_ = lifetime;
+  chain_built_ = false;
+}
+
+
+void IonGenerator::RestoreLifetimes()
+{
+  for (auto& lt: lifetimes_)
+    lt.first->SetPDGLifeTime(lt.second);
+  lifetimes_.clear();
+}
+
+
+void IonGenerator::AddToChain(G4ParticleDefinition* pdef, G4double weight, G4int depth)
+{
+  // Remember the lifetime of every nuclide in the chain, including
+  // those that end it, because they are modified during the generation
+  if (lifetimes_.find(pdef) == lifetimes_.end())
+    lifetimes_[pdef] = pdef->GetPDGLifeTime();
+  G4double lifetime = lifetimes_[pdef];
+
+  // Stable and long-lived descendants end the chain
+  if (depth > 0 && (pdef->GetPDGStable() || lifetime < 0. ||
+                    lifetime > chain_max_lifetime_))
+    return;
+
+  if (depth > 50)
+    G4Exception("[IonGenerator]", "AddToChain()", FatalException,
+                "Decay chain too long.");
+
+  size_t i = 0;
+  while (i < chain_.size() && chain_[i] != pdef) ++i;
+  if (i == chain_.size()) {
+    chain_.push_back(pdef);
+    chain_weights_.push_back(0.);
+  }
+  chain_weights_[i] += weight;
+
+  G4RadioactiveDecay* rdm = dynamic_cast<G4RadioactiveDecay*>
+    (G4ProcessTable::GetProcessTable()->FindProcess("Radioactivation", "GenericIon"));
+  if (!rdm)
+    rdm = dynamic_cast<G4RadioactiveDecay*>
+      (G4ProcessTable::GetProcessTable()->FindProcess("RadioactiveDecay", "GenericIon"));
+  if (!rdm)
+    G4Exception("[IonGenerator]", "AddToChain()", FatalException,
+                "Decay chains require the radioactive decay physics.");
+  G4DecayTable* table = rdm->GetDecayTable(pdef);
+  if (!table) return;
+
+  // Group the decay channels by the ground state of the daughter
+  // nucleus (excited states decay promptly and belong to the decay
+  // of the parent)
+  std::vector<std::pair<G4ParticleDefinition*, G4double>> daughters;
+  G4double total_br = 0.;
+  for (G4int c=0; c<table->entries(); ++c) {
+    G4VDecayChannel* channel = table->GetDecayChannel(c);
+    G4ParticleDefinition* recoil = nullptr;
+    for (G4int d=0; d<channel->GetNumberOfDaughters(); ++d) {
+      G4ParticleDefinition* daughter = channel->GetDaughter(d);
+      if (daughter->GetParticleType() == "nucleus" &&
+          (!recoil || daughter->GetAtomicMass() > recoil->GetAtomicMass()))
+        recoil = daughter;
+    }
+    total_br += channel->GetBR();
+    if (!recoil) continue;
+
+    G4ParticleDefinition* ground = G4IonTable::GetIonTable()->
+      GetIon(recoil->GetAtomicNumber(), recoil->GetAtomicMass(), 0.);
+    // Isomeric transitions to the ground state of the same nuclide
+    if (ground == pdef) continue;
+
+    size_t k = 0;
+    while (k < daughters.size() && daughters[k].first != ground) ++k;
+    if (k == daughters.size()) daughters.push_back(std::make_pair(ground, 0.));
+    daughters[k].second += channel->GetBR();
+  }
+
+  if (total_br <= 0.) return;
+
+  for (const auto& d: daughters)
+    AddToChain(d.first, weight * d.second / total_br, depth + 1);
+}
+
+
+void IonGenerator::BuildDecayChain()
+{
+  RestoreLifetimes();
+  chain_.clear();
+  chain_weights_.clear();
+
+  // The parent is looked up directly so that its lifetime is not reset
+  G4ParticleDefinition* parent =
+    G4IonTable::GetIonTable()->GetIon(atomic_number_, mass_number_, energy_level_);
+  if (!parent) G4Exception("[IonGenerator]", "BuildDecayChain()",
+                           FatalException, "Unable to find the requested ion.");
+
+  AddToChain(parent, 1., 0);
+
+  // Weights given by the user replace the secular-equilibrium ones
+  for (size_t i=0; i<chain_.size(); ++i) {
+    auto it = user_weights_.find(std::make_pair(chain_[i]->GetAtomicNumber(),
+                                                chain_[i]->GetAtomicMass()));
+    if (it != user_weights_.end()) chain_weights_[i] = it->second;
+  }
+
+  chain_table_.Build(chain_weights_.data(), chain_weights_.size());
+  chain_built_ = true;
+  ion_         = nullptr;
+
+  G4cout << "[IonGenerator] Decays per decay of "
+         << chain_[0]->GetParticleName() << " in the chain:" << G4endl;
+  for (size_t i=0; i<chain_.size(); ++i)
+    G4cout << "    " << chain_[i]->GetParticleName()
+           << "  " << chain_weights_[i] << G4endl;
+}
+
+
 void IonGenerator::GeneratePrimaryVertex(G4Event* event)
 {
-  // Pointer declared as static so that it gets allocated only once
-  // (i.e. the ion definition is only looked up in the first event).
-  static G4ParticleDefinition* pdef = IonDefinition();
+  // The ion definition (or the decay chain) is looked up again
+  // only if the configuration has changed since the previous event
+  if (ion_z_ != atomic_number_ || ion_a_ != mass_number_ ||
+      ion_level_ != energy_level_ || ion_t0_ != decay_at_time_zero_) {
+    ion_z_       = atomic_number_;
+    ion_a_       = mass_number_;
+    ion_level_   = energy_level_;
+    ion_t0_      = decay_at_time_zero_;
+    ion_         = nullptr;
+    chain_built_ = false;
+  }
+
+  G4ParticleDefinition* pdef = nullptr;
+
+  if (decay_chain_) {
+    if (!chain_built_) BuildDecayChain();
+
+    // Only the chosen member decays in this event: the others, and the
+    // nuclides that end the chain, are made stable so that the
+    // descendants of the chosen member are not tracked through the chain
+    pdef = chain_[chain_table_.Sample()];
+    for (auto& lt: lifetimes_) {
+      if (lt.first == pdef)
+        lt.first->SetPDGLifeTime(decay_at_time_zero_ ? 1.*ps : lt.second);
+      else
+        lt.first->SetPDGLifeTime(-1.);
+    }
+  }
+  else {
+    if (!ion_) {
+      RestoreLifetimes();
+      chain_built_ = false;
+      ion_ = IonDefinition();
+    }
+    pdef = ion_;
+  }
+
   // Create the new primary particle (i.e. the ion)
   G4PrimaryParticle* ion = new G4PrimaryParticle(pdef);
 
@@ -4,6 +4,8 @@
 // This class is the primary generator for events consisting in the decay
 // of a radioactive ion. The user must specify via configuration parameters
 // the atomic number, mass number and energy level of the isotope of interest.
+// Optionally, the members of the decay chain of the ion are generated as
+// separate decays, weighted by their activity in secular equilibrium.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -11,8 +13,13 @@
 #ifndef ION_GENERATOR_H
 #define ION_GENERATOR_H
 
+#include "AliasTable.h"
+
 #include <G4VPrimaryGenerator.hh>
 
+#include <map>
+#include <vector>
+
 class G4Event;
 class G4GenericMessenger;
 class G4ParticleDefinition;
@@ -37,6 +44,18 @@ namespace nexus{
   private:
     G4ParticleDefinition* IonDefinition();
 
+    // Build the list of chain members starting from the configured ion,
+    // with the number of decays of each member per decay of the parent
+    void BuildDecayChain();
+    // Add a nuclide (and its descendants) to the chain with the given weight
+    void AddToChain(G4ParticleDefinition* pdef, G4double weight, G4int depth);
+    // Override the secular-equilibrium weight of a chain member ("Z A weight")
+    void SetChainWeight(G4String params);
+    // Set the lifetime above which descendants end the chain
+    void SetChainMaxLifetime(G4double lifetime);
+    // Give back the lifetimes modified to generate the ion or the chain
+    void RestoreLifetimes();
+
  private:
     G4int atomic_number_, mass_number_;
     G4double energy_level_;
@@ -44,6 +63,21 @@ namespace nexus{
     G4String region_;
     G4GenericMessenger* msg_;
     const GeometryBase* geom_;
+
+    G4ParticleDefinition* ion_; ///< Cached ion definition
+    G4int ion_z_, ion_a_;       ///< Parameters the cached ion was built for
+    G4double ion_level_;
+    G4bool ion_t0_;
+
+    G4bool decay_chain_;          ///< Generate the decay chain of the ion?
+    G4double chain_max_lifetime_; ///< Longer-lived descendants end the chain (default: 1 year)
+    G4bool chain_built_;          ///< Is the chain up to date?
+
+    std::vector<G4ParticleDefinition*> chain_;  ///< Members of the decay chain
+    std::vector<G4double> chain_weights_;       ///< Decays per decay of the parent
+    std::map<G4ParticleDefinition*, G4double> lifetimes_; ///< Original lifetimes of the modified nuclides
+    std::map<std::pair<G4int, G4int>, G4double> user_weights_; ///< Weights set by the user
+    AliasTable chain_table_; ///< Selection of the chain member of each event
   };
 
 } // end namespace nexus
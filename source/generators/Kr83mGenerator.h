@@ -10,7 +10,8 @@
 #ifndef Kr83m_GENERATOR_H
 #define Kr83m_GENERATOR_H
 
-#include <vector>
+#include "LineEmitter.h"
+
 #include <G4VPrimaryGenerator.hh>
 
 class G4Event;
@@ -66,9 +67,8 @@ namespace nexus {
     G4double energy_9_; // ... from the JP 7/2+ to the Kr83 fundamental state.
     G4double probGamma_9_; // ...The probability for a gamma instead of an EC conversion (related to the alpha EC)
     G4double lifetime_9_; // ...The lifetime of the intermediate state.
-    std::vector<double> energy_Xrays_; // Energies of various X-ray, as the Kr83 atom relaxes to
-    std::vector<double> probability_Xrays_; // Probability to emit an X-ray of the above energy, per decay.
-                                            // We make cumulative, for easy access for random number.
+    LineEmitter xrays_; // X-rays emitted as the Kr83 atom relaxes, with their probability per decay
+    LineEmitter transition_9_; // Gamma or conversion electron of the 9.4 keV transition
 
     G4String region_;
     G4ParticleDefinition*  particle_defgamma_;
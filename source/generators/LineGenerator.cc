@@ -0,0 +1,121 @@
+// ----------------------------------------------------------------------------
+// nexus | LineGenerator.cc
+//
+// This class is the primary generator of decays of calibration sources
+// described by a table of emission lines (particle, energy and
+// probability per decay) given in the configuration macro. Lines in the
+// same group are mutually exclusive; different groups are independent
+// (e.g. gammas in cascade).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "LineGenerator.h"
+
+#include "DetectorConstruction.h"
+#include "GeometryBase.h"
+#include "FactoryBase.h"
+
+#include <G4Event.hh>
+#include <G4GenericMessenger.hh>
+#include <G4RunManager.hh>
+#include <G4ParticleTable.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4UIcommand.hh>
+
+#include <sstream>
+
+using namespace nexus;
+
+REGISTER_CLASS(LineGenerator, G4VPrimaryGenerator)
+
+
+LineGenerator::LineGenerator():
+  G4VPrimaryGenerator(), msg_(nullptr), geom_(nullptr), region_("")
+{
+  msg_ = new G4GenericMessenger(this, "/Generator/LineGenerator/",
+                                "Control commands of the emission-line generator.");
+
+  msg_->DeclareMethod("line", &LineGenerator::AddLine,
+                      "Add an emission line: group particle energy unit probability.");
+
+  msg_->DeclareProperty("region", region_,
+                        "Set the region of the geometry where the vertex will be generated.");
+
+  msg_->DeclareMethod("bias_volume", &LineGenerator::SetBiasVolume,
+                      "Favour directions pointing to this physical volume "
+                      "(events are weighted accordingly).");
+  G4GenericMessenger::Command& bias_fraction =
+    msg_->DeclareMethod("bias_fraction", &LineGenerator::SetBiasFraction,
+                        "Fraction of the directions generated towards the bias volume.");
+  bias_fraction.SetParameterName("bias_fraction", false);
+  bias_fraction.SetRange("bias_fraction>=0. && bias_fraction<1.");
+
+  DetectorConstruction* detconst = (DetectorConstruction*)
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction();
+  geom_ = detconst->GetGeometry();
+}
+
+
+
+LineGenerator::~LineGenerator()
+{
+  delete msg_;
+}
+
+
+
+void LineGenerator::AddLine(G4String params)
+{
+  std::istringstream iss(params);
+  G4int group;
+  G4String name, unit;
+  G4double energy, probability;
+  if (!(iss >> group >> name >> energy >> unit >> probability))
+    G4Exception("[LineGenerator]", "AddLine()", FatalException,
+                "Expected: group particle energy unit probability.");
+
+  G4ParticleDefinition* particle =
+    G4ParticleTable::GetParticleTable()->FindParticle(name);
+  if (!particle) {
+    G4String msg = "Unknown particle " + name;
+    G4Exception("[LineGenerator]", "AddLine()", FatalException, msg);
+  }
+
+  groups_[group].AddLine(particle, energy * G4UIcommand::ValueOf(unit), probability);
+}
+
+
+
+void LineGenerator::SetBiasVolume(G4String name)
+{
+  bias_.SetTargetVolume(name);
+}
+
+
+
+void LineGenerator::SetBiasFraction(G4double fraction)
+{
+  bias_.SetFraction(fraction);
+}
+
+
+
+void LineGenerator::GeneratePrimaryVertex(G4Event* event)
+{
+  if (groups_.empty())
+    G4Exception("[LineGenerator]", "GeneratePrimaryVertex()",
+                FatalException, "No emission lines defined.");
+
+  G4ThreeVector position = geom_->GenerateVertex(region_);
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, 0.);
+
+  for (const auto& group: groups_) {
+    G4int line = group.second.SampleLine();
+    if (line >= 0)
+      group.second.AddPrimaries(line, vertex, 0.,
+                                bias_.IsActive() ? &bias_ : nullptr);
+  }
+
+  event->AddPrimaryVertex(vertex);
+}
@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+// nexus | LineGenerator.h
+//
+// This class is the primary generator of decays of calibration sources
+// described by a table of emission lines (particle, energy and
+// probability per decay) given in the configuration macro. Lines in the
+// same group are mutually exclusive; different groups are independent
+// (e.g. gammas in cascade).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef LINE_GENERATOR_H
+#define LINE_GENERATOR_H
+
+#include "LineEmitter.h"
+#include "DirectionBiasing.h"
+
+#include <G4VPrimaryGenerator.hh>
+
+#include <map>
+
+class G4Event;
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  class GeometryBase;
+
+  class LineGenerator: public G4VPrimaryGenerator
+  {
+  public:
+    /// Constructor
+    LineGenerator();
+    /// Destructor
+    ~LineGenerator();
+
+    /// This method is invoked at the beginning of the event. It sets
+    /// a primary vertex with the particles of the lines emitted in the decay.
+    void GeneratePrimaryVertex(G4Event*);
+
+  private:
+    /// Add a line given as "group particle energy unit probability"
+    void AddLine(G4String params);
+
+    void SetBiasVolume(G4String);
+    void SetBiasFraction(G4double);
+
+  private:
+    G4GenericMessenger* msg_;
+    const GeometryBase* geom_;
+
+    G4String region_;
+
+    std::map<G4int, LineEmitter> groups_; ///< Groups of exclusive lines
+
+    DirectionBiasing bias_; ///< Importance sampling of the directions
+  };
+
+} // end namespace nexus
+
+#endif
@@ -13,6 +13,8 @@
 #include "MuonsPointSampler.h"
 #include "AddUserInfoToPV.h"
 #include "FactoryBase.h"
+#include "RandomUtils.h"
+#include "CacheFile.h"
 
 #include <G4Event.hh>
 #include <G4GenericMessenger.hh>
@@ -22,10 +24,23 @@
 #include <G4PrimaryVertex.hh>
 #include <G4Event.hh>
 #include <G4RandomDirection.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VSolid.hh>
 #include <Randomize.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace nexus;
 
 REGISTER_CLASS(MuonAngleGenerator, G4VPrimaryGenerator)
@@ -33,7 +48,10 @@ REGISTER_CLASS(MuonAngleGenerator, G4VPrimaryGenerator)
 MuonAngleGenerator::MuonAngleGenerator():
   G4VPrimaryGenerator(), msg_(0), particle_definition_(0),
   angular_generation_(true), rPhi_(NULL), energy_min_(0.),
-  energy_max_(0.), geom_(0), geom_solid_(0), bInitialize_(false), dist_name_("za")
+  energy_max_(0.), geom_(0), geom_solid_(0), bInitialize_(false), dist_name_("za"),
+  projected_area_(false), target_radius_(0.), trace_length_(0.), n_bins_(0),
+  flux_(0), azimuths_(0), zeniths_(0), energies_(0), azimuth_smear_(0),
+  zenith_smear_(0), energy_smear_(0), cache_map_(0), cache_size_(0), cache_dir_("")
 {
   msg_ = new G4GenericMessenger(this, "/Generator/MuonAngleGenerator/",
 				"Control commands of muongenerator.");
@@ -60,6 +78,8 @@ MuonAngleGenerator::MuonAngleGenerator():
 			"Name of the file containing angular distribution.");
   msg_->DeclareProperty("angle_dist", dist_name_,
 			"Name of the angular distribution histogram.");
+  msg_->DeclareProperty("cache_dir", cache_dir_,
+			"Directory for the binary cache of the distribution (default: next to the file).");
 
   G4GenericMessenger::Command& rotation =
     msg_->DeclareProperty("azimuth_rotation", axis_rotation_,
@@ -68,6 +88,10 @@ MuonAngleGenerator::MuonAngleGenerator():
   rotation.SetParameterName("azimuth", false);
   rotation.SetRange("azimuth>0.");
 
+  msg_->DeclareProperty("projected_area", projected_area_,
+			"Generate the vertex on the outer surface of the geometry, "
+			"uniformly over the area that sees the target volume.");
+
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
 
@@ -76,36 +100,60 @@ MuonAngleGenerator::MuonAngleGenerator():
 
 MuonAngleGenerator::~MuonAngleGenerator()
 {
+  if (cache_map_) munmap(cache_map_, cache_size_);
   delete msg_;
 }
 
-void MuonAngleGenerator::LoadMuonDistribution()
+
+namespace {
+
+  // Description of the binary cache of a muon distribution, after the
+  // header of the cache files. It is followed by the distribution stored
+  // column by column as doubles, in the order flux, azimuth, zenith,
+  // azimuth smear, zenith smear and, for "zae" distributions, energy
+  // and energy smear.
+  struct MuonCacheInfo {
+    uint32_t n_cols;
+    uint32_t reserved;
+    uint64_t n_bins;
+    uint64_t csv_size;  ///< Size of the CSV file the cache was built from
+    int64_t  csv_mtime; ///< Modification time of the CSV file
+  };
+
+  const char     kMuonCacheMagic[4] = {'N', 'M', 'U', 'C'};
+  const uint32_t kMuonCacheVersion  = 2;
+
+  const size_t kMuonCacheOffset = sizeof(nexus::CacheHeader) + sizeof(MuonCacheInfo);
+
+}
+
+
+G4String MuonAngleGenerator::CacheFileName() const
+{
+  if (cache_dir_ == "")
+    return ang_file_ + ".bin";
+
+  // Keep only the file name of the CSV
+  G4String name = ang_file_;
+  size_t slash = name.rfind('/');
+  if (slash != std::string::npos) name = name.substr(slash + 1);
+  return cache_dir_ + "/" + name + ".bin";
+}
+
+
+G4int MuonAngleGenerator::ParseMuonCSV(std::vector<G4double>& data) const
 {
-  
   // File pointer
   std::ifstream fin(ang_file_);
-  
+
   // Check if file has opened properly
-  if (!fin.is_open() && angular_generation_){
+  if (!fin.is_open()){
     G4Exception("[MuonAngleGenerator]", "LoadMuonDistribution()",
                 FatalException, " could not read in the input muon distributions from CSV file ");
   }
 
-  // Check the input filename for the keyword Energy
-  size_t found = ang_file_.find("Energy");
-  if (found!=std::string::npos){
-    
-    // Only angle option, but energy specified
-    if (dist_name_ == "za")
-      G4Exception("[MuonAngleGenerator]", "LoadMuonDistribution()",
-                FatalException, " Angular + Energy file specified with angle_dist=za option selected, use angle_dist=zae ");
-  }
-  // File name does not contain the word Energy
-  else {
-    if (dist_name_ == "zae")
-      G4Exception("[MuonAngleGenerator]", "LoadMuonDistribution()",
-                FatalException, " Angular file specified with angle_dist=zae option selected, use angle_dist=za ");
-  }
+  const G4int n_cols = (dist_name_ == "zae") ? 7 : 5;
+  std::vector<std::vector<G4double>> cols(n_cols);
 
   // Read the Data from the file as strings
   std::string s_header, s_flux, s_azimuth, s_zenith, s_energy;
@@ -123,12 +171,6 @@ void MuonAngleGenerator::LoadMuonDistribution()
       std::getline(fin, s_zenith, ',');
       std::getline(fin, s_azimuth_smear, ',');
       std::getline(fin, s_zenith_smear, '\n');
-
-      flux_.push_back(stod(s_flux));
-      azimuths_.push_back(stod(s_azimuth));
-      zeniths_.push_back(stod(s_zenith));
-      azimuth_smear_.push_back(stod(s_azimuth_smear));
-      zenith_smear_.push_back(stod(s_zenith_smear));
     }
     // Angle + Energy input
     if (s_header == "value" && dist_name_ == "zae"){
@@ -140,24 +182,161 @@ void MuonAngleGenerator::LoadMuonDistribution()
       std::getline(fin, s_zenith_smear, ',');
       std::getline(fin, s_energy_smear, '\n');
 
-      flux_.push_back(stod(s_flux));
-      azimuths_.push_back(stod(s_azimuth));
-      zeniths_.push_back(stod(s_zenith));
-      energies_.push_back(stod(s_energy));
-      azimuth_smear_.push_back(stod(s_azimuth_smear));
-      zenith_smear_.push_back(stod(s_zenith_smear));
-      energy_smear_.push_back(stod(s_energy_smear));
+      cols[5].push_back(stod(s_energy));
+      cols[6].push_back(stod(s_energy_smear));
     }
 
+    if (s_header == "value"){
+      cols[0].push_back(stod(s_flux));
+      cols[1].push_back(stod(s_azimuth));
+      cols[2].push_back(stod(s_zenith));
+      cols[3].push_back(stod(s_azimuth_smear));
+      cols[4].push_back(stod(s_zenith_smear));
+    }
+
+  }
+
+  // Store the columns one after the other
+  data.clear();
+  for (const auto& col: cols)
+    data.insert(data.end(), col.begin(), col.end());
+
+  return cols[0].size();
+}
+
+
+G4bool MuonAngleGenerator::MapMuonCache(const G4String& filename, G4int n_cols,
+                                        uint64_t csv_size, int64_t csv_mtime)
+{
+  G4int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < kMuonCacheOffset) {
+    close(fd);
+    return false;
   }
 
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after closing the descriptor
+  close(fd);
+  if (addr == MAP_FAILED) return false;
+
+  CacheHeader hdr;
+  MuonCacheInfo info;
+  std::memcpy(&hdr, addr, sizeof(hdr));
+  std::memcpy(&info, static_cast<const char*>(addr) + sizeof(hdr), sizeof(info));
+
+  // Discard caches built from a different (or modified) CSV file
+  const G4bool valid =
+    CheckCacheHeader(hdr, st.st_size, kMuonCacheMagic, kMuonCacheVersion) &&
+    info.n_cols == uint32_t(n_cols) &&
+    info.csv_size == csv_size && info.csv_mtime == csv_mtime &&
+    kMuonCacheOffset + info.n_bins * n_cols * sizeof(G4double) == size_t(st.st_size);
+
+  if (!valid) {
+    munmap(addr, st.st_size);
+    return false;
+  }
 
-  // Convert flux vector to arr
-  G4double arr_flux[flux_.size()];
-  std::copy(flux_.begin(), flux_.end(), arr_flux);
+  cache_map_  = addr;
+  cache_size_ = st.st_size;
+  n_bins_     = info.n_bins;
+  SetColumns(reinterpret_cast<const G4double*>
+             (static_cast<const char*>(addr) + kMuonCacheOffset));
+
+  return true;
+}
+
+
+void MuonAngleGenerator::WriteMuonCache(const G4String& filename, G4int n_cols,
+                                        uint64_t csv_size, int64_t csv_mtime) const
+{
+  MuonCacheInfo info;
+  info.n_cols    = n_cols;
+  info.reserved  = 0;
+  info.n_bins    = n_bins_;
+  info.csv_size  = csv_size;
+  info.csv_mtime = csv_mtime;
+
+  if (!WriteCacheFile(filename, kMuonCacheMagic, kMuonCacheVersion,
+                      {{&info, sizeof(info)},
+                       {csv_data_.data(), csv_data_.size() * sizeof(G4double)}})) {
+    G4String msg = "Could not write the muon distribution cache " + filename;
+    G4Exception("[MuonAngleGenerator]", "WriteMuonCache()", JustWarning, msg);
+  }
+}
+
+
+void MuonAngleGenerator::SetColumns(const G4double* data)
+{
+  flux_          = data;
+  azimuths_      = data + 1 * n_bins_;
+  zeniths_       = data + 2 * n_bins_;
+  azimuth_smear_ = data + 3 * n_bins_;
+  zenith_smear_  = data + 4 * n_bins_;
+
+  if (dist_name_ == "zae") {
+    energies_     = data + 5 * n_bins_;
+    energy_smear_ = data + 6 * n_bins_;
+  }
+}
+
+
+void MuonAngleGenerator::LoadMuonDistribution()
+{
+
+  // Check the input filename for the keyword Energy
+  size_t found = ang_file_.find("Energy");
+  if (found!=std::string::npos){
+
+    // Only angle option, but energy specified
+    if (dist_name_ == "za")
+      G4Exception("[MuonAngleGenerator]", "LoadMuonDistribution()",
+                FatalException, " Angular + Energy file specified with angle_dist=za option selected, use angle_dist=zae ");
+  }
+  // File name does not contain the word Energy
+  else {
+    if (dist_name_ == "zae")
+      G4Exception("[MuonAngleGenerator]", "LoadMuonDistribution()",
+                FatalException, " Angular file specified with angle_dist=zae option selected, use angle_dist=za ");
+  }
+
+  struct stat csv_stat;
+  if (stat(ang_file_.c_str(), &csv_stat) != 0){
+    G4Exception("[MuonAngleGenerator]", "LoadMuonDistribution()",
+                FatalException, " could not read in the input muon distributions from CSV file ");
+  }
+
+  const G4int n_cols = (dist_name_ == "zae") ? 7 : 5;
+  const G4String cache_file = CacheFileName();
+
+  // Use the binary cache if it is up to date, otherwise parse the CSV
+  // file and (re)build the cache for the next jobs
+  if (!MapMuonCache(cache_file, n_cols, csv_stat.st_size, csv_stat.st_mtime)) {
+    n_bins_ = ParseMuonCSV(csv_data_);
+    WriteMuonCache(cache_file, n_cols, csv_stat.st_size, csv_stat.st_mtime);
+    if (!MapMuonCache(cache_file, n_cols, csv_stat.st_size, csv_stat.st_mtime))
+      SetColumns(csv_data_.data());
+    else
+      std::vector<G4double>().swap(csv_data_);
+  }
+
+  // Weight each bin with the probability that its smeared values are
+  // accepted (zenith >= 0 and energy within the requested window), so
+  // that the sampled values never need to be thrown away
+  std::vector<G4double> weights(n_bins_);
+  for (size_t i=0; i<n_bins_; ++i) {
+    G4double w = flux_[i] *
+      GaussianProbabilityInRange(zeniths_[i], zenith_smear_[i], 0., HUGE_VAL);
+    if (dist_name_ == "zae")
+      w *= GaussianProbabilityInRange(energies_[i]*GeV, energy_smear_[i]*GeV,
+                                      energy_min_, energy_max_);
+    weights[i] = w;
+  }
 
   // Initialise the Random Number Generator based on the flux distribution (in bin index)
-  fRandomGeneral_ = new G4RandGeneral( arr_flux, flux_.size() );
+  flux_table_.Build(weights.data(), weights.size());
 
 }
 
@@ -168,9 +347,23 @@ void MuonAngleGenerator::SetupAngles()
   rPhi_ = new G4RotationMatrix();
   rPhi_->rotateY(-axis_rotation_);
 
-  // Get the solid to check overlap
-  geom_solid_ =
-    geom_->GetLogicalVolume()->GetDaughter(0)->GetLogicalVolume()->GetSolid();
+  // Get the solid to check overlap and its placement
+  G4VPhysicalVolume* target = geom_->GetLogicalVolume()->GetDaughter(0);
+  geom_solid_ = target->GetLogicalVolume()->GetSolid();
+  solid_transform_ =
+    G4AffineTransform(target->GetRotation(), target->GetTranslation()).Inverse();
+
+  // Bounding sphere of the target and distance from which any ray
+  // towards it starts outside the geometry, for the projected-area sampling
+  G4ThreeVector pmin, pmax;
+  geom_solid_->BoundingLimits(pmin, pmax);
+  target_centre_ = solid_transform_.Inverse().TransformPoint((pmin + pmax)/2.);
+  target_radius_ = (pmax - pmin).mag()/2.;
+
+  G4ThreeVector wmin, wmax;
+  geom_->GetLogicalVolume()->GetSolid()->BoundingLimits(wmin, wmax);
+  trace_length_ = (wmax - wmin).mag() + ((wmin + wmax)/2. - target_centre_).mag()
+    + target_radius_;
 
 }
 
@@ -206,8 +399,10 @@ void MuonAngleGenerator::GeneratePrimaryVertex(G4Event* event)
   G4double mass   = particle_definition_->GetPDGMass();
   G4double energy = kinetic_energy + mass;
 
-  G4ThreeVector position = geom_->GenerateVertex(region_);
-  
+  G4ThreeVector position;
+  if (!(angular_generation_ && projected_area_))
+    position = geom_->GenerateVertex(region_);
+
   // Set default momentum and angular variables
   G4ThreeVector p_dir(0., -1., 0.);
   G4double zenith  = p_dir.getTheta();
@@ -216,8 +411,11 @@ void MuonAngleGenerator::GeneratePrimaryVertex(G4Event* event)
   // Overwrite default p_dir, zenith and azimuth from angular distribution file
   if (angular_generation_){
     GetDirection(p_dir, zenith, azimuth, energy, kinetic_energy, mass);
-    while ( !CheckOverlap(position, p_dir) )
-      position = geom_->GenerateVertex(region_);
+    if (projected_area_)
+      position = ProjectedAreaVertex(p_dir);
+    else
+      while ( !CheckOverlap(position, p_dir) )
+        position = geom_->GenerateVertex(region_);
   }
 
   G4double pmod   = std::sqrt(energy*energy - mass*mass);
@@ -268,47 +466,30 @@ void MuonAngleGenerator::GetDirection(G4ThreeVector& dir, G4double& zenith, G4do
                       G4double& energy, G4double& kinetic_energy, G4double mass)
 {
 
-  // Bool to check if zenith has a valid value. If not then resample
-  G4bool invalid_evt = true;
-
-  while(invalid_evt){
-  
-    // Generate random index weighted by the bin contents
-    // Scale by flux vec size, then round to nearest integer to get an index
-    G4int RN_indx = round(fRandomGeneral_->fire()*flux_.size());
-
-    // Correct sampled values by Gaussian smearing
-    azimuth  = azimuths_[RN_indx] + G4RandGauss::shoot( 0., azimuth_smear_[RN_indx]);
-    zenith   = zeniths_[RN_indx]  + G4RandGauss::shoot( 0., zenith_smear_[RN_indx]);
-
-    // Sample and update the energy if angle + energy option specified
-    if (dist_name_ == "zae"){
-      energy   = (energies_[RN_indx]*GeV  + G4RandGauss::shoot( 0., energy_smear_[RN_indx]*GeV));
-      kinetic_energy = energy - mass;
-
-      // Resample if the energy is not in the specified range
-      if (energy < energy_min_ || energy > energy_max_){
-        invalid_evt = true;
-        continue;
-      }
-    }
+  // Generate random index weighted by the bin contents. The bins are
+  // already weighted by the acceptance of the range cuts, so the smeared
+  // values are drawn from Gaussians truncated to the accepted range.
+  size_t RN_indx = flux_table_.Sample();
 
-    // Catch negative value and resample if so
-    if (zenith < 0.0)
-        invalid_evt = true;
-    else
-        invalid_evt = false;
+  // Correct sampled values by Gaussian smearing
+  azimuth  = azimuths_[RN_indx] + G4RandGauss::shoot( 0., azimuth_smear_[RN_indx]);
+  zenith   = TruncatedGaussian(zeniths_[RN_indx], zenith_smear_[RN_indx], 0., HUGE_VAL);
 
-    // Calculate the vector components of the muon
-    dir.setX(sin(zenith) * sin(azimuth));
-    dir.setY(-cos(zenith));
-    dir.setZ(-sin(zenith) * cos(azimuth));
-
-    // Rotate about the Y-Axis
-    dir *= *rPhi_;
-  
+  // Sample and update the energy if angle + energy option specified
+  if (dist_name_ == "zae"){
+    energy = TruncatedGaussian(energies_[RN_indx]*GeV, energy_smear_[RN_indx]*GeV,
+                               energy_min_, energy_max_);
+    kinetic_energy = energy - mass;
   }
 
+  // Calculate the vector components of the muon
+  dir.setX(sin(zenith) * sin(azimuth));
+  dir.setY(-cos(zenith));
+  dir.setZ(-sin(zenith) * cos(azimuth));
+
+  // Rotate about the Y-Axis
+  dir *= *rPhi_;
+
 }
 
 
@@ -318,8 +499,38 @@ G4bool MuonAngleGenerator::CheckOverlap(const G4ThreeVector& vtx,
   // Check for overlap between generated vertex+direction
   // and the geometry.
 
-  if (geom_solid_->DistanceToIn(vtx, dir) == kInfinity)
+  G4ThreeVector local_vtx = solid_transform_.TransformPoint(vtx);
+  G4ThreeVector local_dir = solid_transform_.TransformAxis(dir);
+
+  if (geom_solid_->DistanceToIn(local_vtx, local_dir) == kInfinity)
     return false;
 
   return true;
 }
+
+
+G4ThreeVector MuonAngleGenerator::ProjectedAreaVertex(const G4ThreeVector& dir)
+{
+  // Orthonormal basis of the plane perpendicular to the direction
+  G4ThreeVector u = dir.orthogonal().unit();
+  G4ThreeVector v = dir.cross(u);
+
+  G4VSolid* world_solid = geom_->GetLogicalVolume()->GetSolid();
+
+  while (true) {
+    // Uniform point on the disc covering the target as seen along dir
+    G4double r   = target_radius_ * std::sqrt(G4UniformRand());
+    G4double phi = twopi * G4UniformRand();
+    G4ThreeVector p = target_centre_ + r * (std::cos(phi) * u + std::sin(phi) * v);
+
+    // Move it back along the line to the outer surface of the geometry
+    G4ThreeVector start = p - trace_length_ * dir;
+    G4double dist = world_solid->DistanceToIn(start, dir);
+    if (dist == kInfinity)
+      continue;
+
+    G4ThreeVector vtx = start + dist * dir;
+    if (CheckOverlap(vtx, dir))
+      return vtx;
+  }
+}
@@ -10,9 +10,14 @@
 #ifndef MUON_ANGLE_GENERATOR_H
 #define MUON_ANGLE_GENERATOR_H
 
+#include "AliasTable.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <G4RotationMatrix.hh>
-#include <Randomize.hh>
+#include <G4AffineTransform.hh>
+
+#include <cstdint>
+#include <vector>
 
 class G4GenericMessenger;
 class G4Event;
@@ -55,10 +60,34 @@ namespace nexus {
 
     G4bool CheckOverlap(const G4ThreeVector& vtx, const G4ThreeVector& dir);
 
+    /// Generate a vertex on the outer surface of the geometry that
+    /// sees the target volume along the direction dir, sampled uniformly
+    /// over the area projected perpendicular to dir
+    G4ThreeVector ProjectedAreaVertex(const G4ThreeVector& dir);
+
     /// Load in the Muon Angular/Energy Distribution from CSV file
-    /// and initialise the discrete flux distribution
+    /// and initialise the discrete flux distribution, truncated
+    /// to the requested energy window and to positive zenith angles
     void LoadMuonDistribution();
 
+    /// Parse the CSV file into data, column after column.
+    /// Returns the number of bins.
+    G4int ParseMuonCSV(std::vector<G4double>& data) const;
+
+    /// Name of the binary cache of the distribution file
+    G4String CacheFileName() const;
+
+    /// Memory-map the binary cache, if it is valid for the current CSV file
+    G4bool MapMuonCache(const G4String& filename, G4int n_cols,
+                        uint64_t csv_size, int64_t csv_mtime);
+
+    /// Write the parsed distribution to the binary cache
+    void WriteMuonCache(const G4String& filename, G4int n_cols,
+                        uint64_t csv_size, int64_t csv_mtime) const;
+
+    /// Point the distribution columns to consecutive arrays in data
+    void SetColumns(const G4double* data);
+
 
   private:
     G4GenericMessenger* msg_;
@@ -81,12 +110,24 @@ namespace nexus {
     const GeometryBase* geom_; ///< Pointer to the detector geometry
 
     G4VSolid * geom_solid_;
-
-    std::vector<G4double> flux_, azimuths_, zeniths_, energies_; ///< Values of flux, azimuth and zenith from file
-    std::vector<G4double> azimuth_smear_; ///< List of Azimuth bin smear values
-    std::vector<G4double> zenith_smear_;  ///< List of Zenith bin smear values
-    std::vector<G4double> energy_smear_;  ///< List of Energy bin smear values
-    G4RandGeneral *fRandomGeneral_; ///< Pointer to the RNG flux distribution
+    G4AffineTransform solid_transform_; ///< Vertex frame to solid frame
+
+    G4bool projected_area_; ///< Sample vertices on the projected area of the target
+    G4ThreeVector target_centre_; ///< Centre of the target bounding sphere
+    G4double target_radius_;      ///< Radius of the target bounding sphere
+    G4double trace_length_;       ///< Distance to start outside the geometry
+
+    size_t n_bins_; ///< Number of bins of the distribution
+    const G4double *flux_, *azimuths_, *zeniths_, *energies_; ///< Values of flux, azimuth, zenith and energy from file
+    const G4double *azimuth_smear_; ///< List of Azimuth bin smear values
+    const G4double *zenith_smear_;  ///< List of Zenith bin smear values
+    const G4double *energy_smear_;  ///< List of Energy bin smear values
+
+    std::vector<G4double> csv_data_; ///< Distribution parsed from the CSV file, if it could not be mapped
+    void* cache_map_;   ///< Memory-mapped binary cache of the distribution
+    size_t cache_size_; ///< Size of the mapped cache
+    G4String cache_dir_; ///< Directory of the binary cache
+    AliasTable flux_table_; ///< Flux distribution truncated to the accepted range
   };
 
 } // end namespace nexus
@@ -17,7 +17,6 @@
 #include <G4GenericMessenger.hh>
 #include <G4RunManager.hh>
 #include <G4ParticleTable.hh>
-#include <G4RandomDirection.hh>
 #include <Randomize.hh>
 
 #include "CLHEP/Units/SystemOfUnits.h"
@@ -44,6 +43,14 @@ namespace nexus {
     DetectorConstruction* detconst = (DetectorConstruction*)
       G4RunManager::GetRunManager()->GetUserDetectorConstruction();
     geom_ = detconst->GetGeometry();
+
+    G4ParticleDefinition* gamma =
+      G4ParticleTable::GetParticleTable()->FindParticle("gamma");
+
+    // Back-to-back gammas from the annihilation of the positron
+    // (beta+ branch) and disexcitation gamma of Ne22
+    annihilation_.AddLine(gamma, 510.999*keV, 0.903, true);
+    disexcitation_.AddLine(gamma, 1274.537*keV, 1.);
   }
 
   Na22Generator::~Na22Generator()
@@ -58,59 +65,11 @@ namespace nexus {
     G4PrimaryVertex* vertex =
         new G4PrimaryVertex(position, time);
 
-    G4ParticleDefinition* particle_definition =
-      G4ParticleTable::GetParticleTable()->FindParticle("gamma");
-    // Set masses to PDG values
-    G4double mass = particle_definition->GetPDGMass();
-    // Set charges to PDG value
-    G4double charge = particle_definition->GetPDGCharge();
-
-    G4double rand = G4UniformRand();
-
-    if (rand < 0.903) {
-
-    G4ThreeVector momentum_direction = G4RandomDirection();
-
-    // Calculate cartesian components of momentum
-    G4double energy = 510.999*keV + mass;
-    G4double pmod = std::sqrt(energy*energy - mass*mass);
-    G4double px = pmod * momentum_direction.x();
-    G4double py = pmod * momentum_direction.y();
-    G4double pz = pmod * momentum_direction.z();
-
-     G4PrimaryParticle* particle1 =
-       new G4PrimaryParticle(particle_definition, px, py, pz);
-    particle1->SetMass(mass);
-    particle1->SetCharge(charge);
-    particle1->SetPolarization(0.,0.,0.);
-    vertex->SetPrimary(particle1);
-
-    G4PrimaryParticle* particle2 =
-      new G4PrimaryParticle(particle_definition, -px, -py, -pz);
-    particle2->SetMass(mass);
-    particle2->SetCharge(charge);
-    particle2->SetPolarization(0.,0.,0.);
-    vertex->SetPrimary(particle2);
-
- }
-
-    G4ThreeVector momentum_direction_dis = G4RandomDirection();
-
-    // Calculate cartesian components of momentum of disexcitation gamma
-    G4double energy_dis = 1274.537*keV + mass;
-    G4double pmod_dis = std::sqrt(energy_dis*energy_dis - mass*mass);
-    G4double px_dis = pmod_dis * momentum_direction_dis.x();
-    G4double py_dis = pmod_dis * momentum_direction_dis.y();
-    G4double pz_dis = pmod_dis * momentum_direction_dis.z();
-
-
-     G4PrimaryParticle* gamma_dis =
-       new G4PrimaryParticle(particle_definition, px_dis, py_dis, pz_dis);
-    gamma_dis->SetMass(mass);
-    gamma_dis->SetCharge(charge);
-    gamma_dis->SetPolarization(0.,0.,0.);
-    vertex->SetPrimary(gamma_dis);
+    G4int line = annihilation_.SampleLine();
+    if (line >= 0)
+      annihilation_.AddPrimaries(line, vertex, time);
 
+    disexcitation_.AddPrimaries(disexcitation_.SampleLine(), vertex, time);
 
     evt->AddPrimaryVertex(vertex);
   }
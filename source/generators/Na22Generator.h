@@ -11,6 +11,8 @@
 #ifndef NA22_GENERATOR_H
 #define NA22_GENERATOR_H
 
+#include "LineEmitter.h"
+
 #include <G4VPrimaryGenerator.hh>
 
 class G4Event;
@@ -37,6 +39,9 @@ namespace nexus {
 
     G4String region_;
 
+    LineEmitter annihilation_;  ///< Annihilation gammas of the beta+ branch
+    LineEmitter disexcitation_; ///< Disexcitation gamma
+
   };
 
 }// end namespace nexus
@@ -0,0 +1,33 @@
+// ----------------------------------------------------------------------------
+// nexus | SequentialGenerator.h
+//
+// Interface of the primary generators that read their events in order
+// from an input file. Jobs running a range of the events of a production
+// (shards) use it to start reading at the first event of their range.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SEQUENTIAL_GENERATOR_H
+#define SEQUENTIAL_GENERATOR_H
+
+#include <globals.hh>
+
+namespace nexus {
+
+  class SequentialGenerator
+  {
+  public:
+    virtual ~SequentialGenerator() {}
+
+    /// Skip this number of events of the input, on top of the
+    /// first event chosen by the user, before the first one generated
+    virtual void SetEventOffset(G4int) = 0;
+
+    /// Is the generator reading an input file at the moment?
+    virtual G4bool ReadsInputFile() const = 0;
+  };
+
+} // namespace nexus
+
+#endif
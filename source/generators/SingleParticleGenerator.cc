@@ -76,6 +76,15 @@ costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
   msg_->DeclareProperty("max_phi", phi_max_,
 			"Set maximum phi for the direction of the particle.");
 
+  msg_->DeclareMethod("bias_volume", &SingleParticleGenerator::SetBiasVolume,
+    "Favour isotropic directions pointing to this physical volume "
+    "(events are weighted accordingly).");
+  G4GenericMessenger::Command& bias_fraction =
+    msg_->DeclareMethod("bias_fraction", &SingleParticleGenerator::SetBiasFraction,
+      "Fraction of the directions generated towards the bias volume.");
+  bias_fraction.SetParameterName("bias_fraction", false);
+  bias_fraction.SetRange("bias_fraction>=0. && bias_fraction<1.");
+
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
@@ -102,6 +111,20 @@ void SingleParticleGenerator::SetParticleDefinition(G4String particle_name)
 
 
 
+void SingleParticleGenerator::SetBiasVolume(G4String name)
+{
+  bias_.SetTargetVolume(name);
+}
+
+
+
+void SingleParticleGenerator::SetBiasFraction(G4double fraction)
+{
+  bias_.SetFraction(fraction);
+}
+
+
+
 void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
 {
   // Generate uniform random energy in [E_min, E_max]
@@ -115,13 +138,17 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
   bool fixed_momentum = momentum_ != G4ThreeVector{};
   bool restrict_angle = costheta_min_ != -1. || costheta_max_ != 1. || phi_min_ != 0. || phi_max_ !=2.*pi;
 
+  // Generate an initial position for the particle using the geometry
+  G4ThreeVector position = geom_->GenerateVertex(region_);
+
+  G4double weight = 1.;
   G4ThreeVector p_dir; // it will be set in the if branches below
   if (fixed_momentum) { // if the user provides a momentum direction
     p_dir = momentum_.unit();
   } else if (restrict_angle) { // if the user provides a range of angles
     p_dir = RandomDirectionInRange(costheta_min_, costheta_max_, phi_min_, phi_max_);
   } else {
-    p_dir = G4RandomDirection();
+    p_dir = bias_.Sample(position, weight);
   }
 
   G4ThreeVector p = pmod * p_dir;
@@ -135,14 +162,12 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
     particle->SetPolarization(polarization);
   }
 
-  // Generate an initial position for the particle using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
-
   // Particle generated at start-of-event
   G4double time = 0.;
 
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+  vertex->SetWeight(weight);
 
     // Add particle to the vertex and this to the event
   vertex->SetPrimary(particle);
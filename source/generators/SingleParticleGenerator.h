@@ -14,6 +14,8 @@
 #ifndef SINGLE_PARTICLE_GENERATOR_H
 #define SINGLE_PARTICLE_GENERATOR_H
 
+#include "DirectionBiasing.h"
+
 #include <G4VPrimaryGenerator.hh>
 
 class G4GenericMessenger;
@@ -42,6 +44,9 @@ namespace nexus {
 
     void SetParticleDefinition(G4String);
 
+    void SetBiasVolume(G4String);
+    void SetBiasFraction(G4double);
+
     /// Generate a random kinetic energy with flat probability in
     //  the interval [energy_min, energy_max].
     G4double RandomEnergy() const;
@@ -65,6 +70,7 @@ namespace nexus {
     G4double phi_min_;
     G4double phi_max_;
 
+    DirectionBiasing bias_; ///< Importance sampling of isotropic directions
 
   };
 
@@ -10,7 +10,13 @@
 
 #include <cfloat>
 #include <complex>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
 #include "decay0.h"
+#include "CacheFile.h"
 #include <G4RandomDirection.hh>
 #include <Randomize.hh>
 
@@ -18,6 +24,8 @@
 #include <gsl/gsl_sf_gamma.h>
 #include <gsl/gsl_errno.h>
 
+const double decay0::tableStep_ = 1.e-3; // 1 keV, as spthe1_
+
 // Global variables used in the function, that are in global space, as they are used in integrations.
 int decay0FunctionsZdbb_; // the Z of the
 bbFinalState::bbFinalState():
@@ -41,7 +49,8 @@ emass_(0.51099906),
 nuclideName_("Xe136"),
 fsNum_(0),
 modebb_(0),
-modebbOld_(0)
+modebbOld_(0),
+useTable_(true)
 {
   ebb1_ = 0.;
   ebb2_ = 4.3; // original code, line 628
@@ -49,13 +58,16 @@ modebbOld_(0)
   fillInfo();
 }
 decay0::decay0(const std::string nuclide, int finalStateNumber,
-               int decayModeNumber, double eRangeLow, double eRangeHigh):
+               int decayModeNumber, double eRangeLow, double eRangeHigh,
+               const std::string tableCacheDir):
 ready_(false),
 emass_(0.51099906),
 nuclideName_(nuclide),
 fsNum_(finalStateNumber),
 modebb_(decayModeNumber),
-modebbOld_(decayModeNumber)
+modebbOld_(decayModeNumber),
+useTable_(true),
+tableCacheDir_(tableCacheDir)
 {
   ebb1_ = eRangeLow;
   ebb2_ = eRangeHigh; // for mode 4, 2nbbdecay.
@@ -381,9 +393,160 @@ void decay0::initSpectrum() {
 	   }
 	   toallevents_ = r1/r2;
      }
+     if ((modebb_ == 4) ||  (modebb_ == 5) || (modebb_ == 6) || (modebb_ == 8) ||
+         (modebb_ == 13) ||  (modebb_ == 14) || (modebb_ == 15) || (modebb_ == 16)) initTable();
      std::cout << " .... starting the generation " << std::endl;
 }
 //
+// The joint spectrum of the two electrons is tabulated once, in cells of 1 keV x 1 keV,
+// so that the energies can be sampled by inverse-CDF lookup instead of evaluating
+// fe2_modX thousands of times per event. The cells are sampled first in e1, from the
+// marginal distribution, and then in e2, from the conditional distribution of that e1 bin.
+//
+void decay0::initTable() {
+  e1Cdf_.clear(); e2Offset_.clear(); e2First_.clear(); e2Cdf_.clear();
+  const std::string fileName = tableFileName();
+  if ((fileName != "") && readTable(fileName)) {
+    std::cout << " decay0::initTable, tabulated spectrum read from " << fileName << std::endl;
+    return;
+  }
+  double (*fe12)(double, void*) = 0;
+  switch(modebb_) {
+    case 4:  fe12 = &decay0::fe12_mod4;  break;
+    case 5:  fe12 = &decay0::fe12_mod5;  break;
+    case 6:  fe12 = &decay0::fe12_mod6;  break;
+    case 8:  fe12 = &decay0::fe12_mod8;  break;
+    case 13: fe12 = &decay0::fe12_mod13; break;
+    case 14: fe12 = &decay0::fe12_mod14; break;
+    case 15: fe12 = &decay0::fe12_mod15; break;
+    case 16: fe12 = &decay0::fe12_mod16; break;
+    default: return;
+  }
+  std::vector<double> params(10, 0.);
+  params[0] = emass_;
+  params[1] = bbNucl_.Zdbb_;
+  params[2] = e0_;
+  const double emax = std::min(ebb2_, e0_);
+  const int n1 = static_cast<int>(std::ceil(emax/tableStep_));
+  std::vector<double> row;
+  double total = 0.;
+  e2Offset_.push_back(0);
+  for (int i = 0; i != n1; i++) {
+    const double e1 = (i + 0.5)*tableStep_;
+    params[3] = e1;
+    // e2 bins compatible with the energy window, ebb1 <= e1+e2 <= ebb2, and with e1+e2 <= e0
+    const int j1 = static_cast<int>(std::max(0., ebb1_ - e1)/tableStep_);
+    const int j2 = static_cast<int>(std::ceil((emax - e1)/tableStep_));
+    row.clear();
+    double sum = 0.;
+    for (int j = j1; j < j2; j++) {
+      const double e2 = (j + 0.5)*tableStep_;
+      const double esum = e1 + e2;
+      if ((esum >= ebb1_) && (esum <= ebb2_) && (esum <= e0_)) sum += fe12(e2, &params[0]);
+      row.push_back(sum);
+    }
+    e2First_.push_back(j1);
+    for (size_t j = 0; j != row.size(); j++)
+      e2Cdf_.push_back((sum > 0.) ? static_cast<float>(row[j]/sum) : 1.f);
+    if (!row.empty()) e2Cdf_.back() = 1.f;
+    e2Offset_.push_back(e2Cdf_.size());
+    total += sum;
+    e1Cdf_.push_back(total);
+  }
+  if (total <= 0.) {
+    std::cerr << " decay0::initTable, empty spectrum for decay mode " << modebb_
+              << ", the energies will be sampled by rejection " << std::endl;
+    e1Cdf_.clear(); e2Offset_.clear(); e2First_.clear(); e2Cdf_.clear();
+    return;
+  }
+  if (fileName != "") writeTable(fileName);
+}
+//
+// Name of the file where the table is cached, which encodes everything the table depends on.
+//
+std::string decay0::tableFileName() const {
+  if (tableCacheDir_ == "") return "";
+  std::ostringstream name;
+  name << tableCacheDir_ << "/decay0_" << nuclideName_ << "_fs" << fsNum_
+       << "_mode" << modebb_ << "_" << std::fixed << std::setprecision(6)
+       << ebb1_ << "_" << ebb2_ << ".table";
+  return name.str();
+}
+//
+// Binary layout: the header of the nexus cache files, the parameters of the table,
+// which must match the current ones, and the sizes and contents of the four arrays.
+//
+namespace {
+  const char kTableMagic[4] = {'D', '0', 'T', 'B'};
+  const uint32_t kTableVersion = 1;
+}
+bool decay0::readTable(const std::string &fileName) {
+  std::ifstream in(fileName.c_str(), std::ios::binary | std::ios::ate);
+  if (!in.good()) return false;
+  const uint64_t fileSize = in.tellg();
+  in.seekg(0);
+  nexus::CacheHeader cacheHeader;
+  double header[5];
+  size_t sizes[2];
+  in.read(reinterpret_cast<char*>(&cacheHeader), sizeof(cacheHeader));
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  in.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+  if (!in.good() || !nexus::CheckCacheHeader(cacheHeader, fileSize, kTableMagic, kTableVersion) ||
+      (header[0] != e0_) || (header[1] != ebb1_) || (header[2] != ebb2_) ||
+      (header[3] != tableStep_) || (header[4] != static_cast<double>(modebb_))) {
+    std::cerr << " decay0::initTable, ignoring incompatible table file " << fileName << std::endl;
+    return false;
+  }
+  e1Cdf_.resize(sizes[0]);
+  e2First_.resize(sizes[0]);
+  e2Offset_.resize(sizes[0] + 1);
+  e2Cdf_.resize(sizes[1]);
+  in.read(reinterpret_cast<char*>(e1Cdf_.data()), e1Cdf_.size()*sizeof(double));
+  in.read(reinterpret_cast<char*>(e2First_.data()), e2First_.size()*sizeof(int));
+  in.read(reinterpret_cast<char*>(e2Offset_.data()), e2Offset_.size()*sizeof(size_t));
+  in.read(reinterpret_cast<char*>(e2Cdf_.data()), e2Cdf_.size()*sizeof(float));
+  if (!in.good() || e1Cdf_.empty() || (e2Offset_.back() != e2Cdf_.size())) {
+    std::cerr << " decay0::initTable, corrupted table file " << fileName << std::endl;
+    e1Cdf_.clear(); e2Offset_.clear(); e2First_.clear(); e2Cdf_.clear();
+    return false;
+  }
+  return true;
+}
+void decay0::writeTable(const std::string &fileName) const {
+  const double header[5] = {e0_, ebb1_, ebb2_, tableStep_, static_cast<double>(modebb_)};
+  const size_t sizes[2] = {e1Cdf_.size(), e2Cdf_.size()};
+  const bool written = nexus::WriteCacheFile(fileName, kTableMagic, kTableVersion,
+    {{header, sizeof(header)},
+     {sizes, sizeof(sizes)},
+     {e1Cdf_.data(), e1Cdf_.size()*sizeof(double)},
+     {e2First_.data(), e2First_.size()*sizeof(int)},
+     {e2Offset_.data(), e2Offset_.size()*sizeof(size_t)},
+     {e2Cdf_.data(), e2Cdf_.size()*sizeof(float)}});
+  if (!written)
+    std::cerr << " decay0::initTable, cannot write table file " << fileName << std::endl;
+}
+void decay0::sampleTable(double &e1, double &e2) const {
+  const size_t n1 = e1Cdf_.size();
+  size_t i = std::upper_bound(e1Cdf_.begin(), e1Cdf_.end(),
+                              e1Cdf_.back()*G4UniformRand()) - e1Cdf_.begin();
+  if (i >= n1) i = n1 - 1;
+  while ((i > 0) && (e2Offset_[i] == e2Offset_[i+1])) i--; // no e2 bins for this e1
+  std::vector<float>::const_iterator first = e2Cdf_.begin() + e2Offset_[i];
+  std::vector<float>::const_iterator last = e2Cdf_.begin() + e2Offset_[i+1];
+  size_t k = std::upper_bound(first, last, static_cast<float>(G4UniformRand())) - first;
+  if (k >= static_cast<size_t>(last - first)) k = last - first - 1;
+  const size_t j = e2First_[i] + k;
+  // Uniform within the cell, rejecting the corners beyond the kinematic limits
+  for (int t = 0; t != 100; t++) {
+    e1 = (i + G4UniformRand())*tableStep_;
+    e2 = (j + G4UniformRand())*tableStep_;
+    const double esum = e1 + e2;
+    if ((esum >= ebb1_) && (esum <= ebb2_) && (esum <= e0_)) return;
+  }
+  e1 = (i + 0.5)*tableStep_;
+  e2 = (j + 0.5)*tableStep_;
+}
+//
 // Subroutine GENBBsub generates the events of decay of natural
 // radioactive nuclides and various modes of double beta decay.
 // GENBB units: energy and moment - MeV and MeV/c; time - sec.
@@ -449,8 +612,14 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
 // sampling the energies: first e-/e+ Acceptance/rejection method (Von Neumann), as far as I can tell.
   double e2=0.;
   int numThrow = 0;
+  const bool fromTable = IsTabulated();
+  if (fromTable) {
+    double e1 = 0.;
+    sampleTable(e1, e2);
+    e1_ = e1;
+  }
 //  std::cerr << " ebb1 " << ebb1_  <<  " ebb2 " << ebb2_ << std::endl;
-  while(true) {
+  while(!fromTable) {
      if (modebb_ != 10) e1_ = ebb2_*G4UniformRand();
      else e1_ = ebb1_ + (ebb2_ - ebb1_)*G4UniformRand();
 //     if ((e0_ - e1_) < 0.) continue; //not needed if energy range are set properly.
@@ -462,7 +631,9 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
                                        << " times ... " << std::endl;
   }
 //  second e-/e+ or X-ray
-   if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
+   if (fromTable) {
+// both energies already sampled from the tabulated joint spectrum
+   } else if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
           (modebb_ == 7) || (modebb_ == 17) || (modebb_==18)) {
 // modes with no emission of other particles beside of two e-/e+:
 //  energy of second e-/e+ is calculated
@@ -54,7 +54,8 @@ class decay0 {
 
      decay0();
      decay0(const std::string nuclide, int finalStateNumber, int decayModeNumber,
-                 double eRangeLow=0.0, double eRangeHigh=4.3); // no limits, be default. (for 2nbbdecay. )
+                 double eRangeLow=0.0, double eRangeHigh=4.3, // no limits, be default. (for 2nbbdecay. )
+                 const std::string tableCacheDir=""); // where the tabulated spectrum is cached, if not empty
      ~decay0();
     void decay0DoIt(std::vector<decay0Part> &outPart) const ;
     void fillInfo(); // to be used if the Nuclide, final state or decay mode is changed...Not advised..
@@ -91,9 +92,25 @@ class decay0 {
     mutable double ebb1_;
     mutable double ebb2_;
     mutable std::vector<double> spthe2_;
+    //
+    // Tabulated joint spectrum of the two electrons, for the modes where the energy
+    // of the second one is random (4, 5, 6, 8, 13-16). Bins of tableStep_ in both e1 and e2.
+    //
+    static const double tableStep_;
+    bool useTable_; // sample the energies from the table, if available
+    std::string tableCacheDir_;
+    std::vector<double> e1Cdf_; // cumulative distribution of e1 (not normalized)
+    std::vector<size_t> e2Offset_; // first entry of each e1 bin in e2Cdf_ (size: number of e1 bins + 1)
+    std::vector<int> e2First_; // first e2 bin of each e1 bin
+    std::vector<float> e2Cdf_; // normalized cumulative distribution of e2, for each e1 bin
 
     void initSpectrum(); // Called from fillInfo, initialize array for matrix element, kinematics and so forth.
     void decay0DoItbb(std::vector<decay0Part> &outPart) const; // Main method, generate the two electrons.
+    void initTable(); // Called from initSpectrum, tabulate the joint spectrum of e1 and e2.
+    std::string tableFileName() const;
+    bool readTable(const std::string &fileName);
+    void writeTable(const std::string &fileName) const;
+    void sampleTable(double &e1, double &e2) const; // Inverse-CDF sampling of both energies.
     void Ba136low(std::vector<decay0Part> &outPart) const;  // Baryum 136 de-excitation.
 //    void Xe130low(std::vector<decay0Part> &outPart) const;  // Xenon de-excitation. // we (NEXT) don't care...
 
@@ -156,6 +173,9 @@ class decay0 {
     inline size_t GetFinalStateNumber() { return fsNum_;}
     inline size_t GetDecayModeNumber() { return modebb_;}
     inline double GetEffectiveRatioToOfEvents() {return toallevents_; }
+    // Sampling of the energies from the tabulated spectrum (default) or by rejection, as in the original code
+    inline void SetTabulatedSampling(bool t) { useTable_ = t; }
+    inline bool IsTabulated() const { return useTable_ && !e1Cdf_.empty(); }
 
 };
 #endif
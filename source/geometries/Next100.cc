@@ -15,6 +15,7 @@
 #include "Next100Ics.h"
 #include "Next100InnerElements.h"
 #include "FactoryBase.h"
+#include "StartupTimer.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Box.hh>
@@ -95,7 +96,9 @@ namespace nexus {
     // on the outside.
     if (lab_walls_){
       // We want to simulate the walls (for muons in most cases).
+      StartupTimer::Start("geometry/LSCHallA");
       hallA_walls_->Construct();
+      StartupTimer::Stop("geometry/LSCHallA");
       hallA_logic_ = hallA_walls_->GetLogicalVolume();
       G4double hallA_length = hallA_walls_->GetLSCHallALength();
       // Since the walls will be displaced need to make the
@@ -118,7 +121,9 @@ namespace nexus {
 
     // VESSEL (initialize first since it defines EL position)
     vessel_->SetELtoTPdistance(gate_tracking_plane_distance_);
+    StartupTimer::Start("geometry/Next100Vessel");
     vessel_->Construct();
+    StartupTimer::Stop("geometry/Next100Vessel");
     G4LogicalVolume* vessel_logic = vessel_->GetLogicalVolume();
     G4LogicalVolume* vessel_internal_logic  = vessel_->GetInternalLogicalVolume();
     G4VPhysicalVolume* vessel_internal_phys = vessel_->GetInternalPhysicalVolume();
@@ -126,7 +131,9 @@ namespace nexus {
     gate_zpos_in_vessel_ = vessel_->GetELzCoord();
 
     // SHIELDING
+    StartupTimer::Start("geometry/Next100Shielding");
     shielding_->Construct();
+    StartupTimer::Stop("geometry/Next100Shielding");
     shielding_->SetELzCoord(gate_zpos_in_vessel_);
     G4LogicalVolume* shielding_logic     = shielding_->GetLogicalVolume();
     G4LogicalVolume* shielding_air_logic = shielding_->GetAirLogicalVolume();
@@ -142,7 +149,9 @@ namespace nexus {
     inner_elements_->SetELzCoord(gate_zpos_in_vessel_);
     inner_elements_->SetELtoSapphireWDWdistance(gate_sapphire_wdw_distance_);
     inner_elements_->SetELtoTPdistance         (gate_tracking_plane_distance_);
+    StartupTimer::Start("geometry/Next100InnerElements");
     inner_elements_->Construct();
+    StartupTimer::Stop("geometry/Next100InnerElements");
 
     // INNER COPPER SHIELDING
     ics_->SetLogicalVolume(vessel_internal_logic);
@@ -150,7 +159,9 @@ namespace nexus {
     ics_->SetELtoSapphireWDWdistance(gate_sapphire_wdw_distance_);
     ics_->SetELtoTPdistance         (gate_tracking_plane_distance_);
     ics_->SetPortZpositions(vessel_->GetPortZpositions());
+    StartupTimer::Start("geometry/Next100Ics");
     ics_->Construct();
+    StartupTimer::Stop("geometry/Next100Ics");
 
     G4ThreeVector gate_pos(0., 0., -gate_zpos_in_vessel_);
     if (lab_walls_){
@@ -12,6 +12,7 @@
 #include "IonizationSD.h"
 #include "OpticalMaterialProperties.h"
 #include "UniformElectricDriftField.h"
+#include "FieldMapDriftField.h"
 #include "XenonProperties.h"
 #include "CylinderPointSampler2020.h"
 
@@ -83,6 +84,7 @@ Next100FieldCage::Next100FieldCage():
   // Diffusion constants
   drift_transv_diff_ (1. * mm/sqrt(cm)),
   drift_long_diff_ (.3 * mm/sqrt(cm)),
+  drift_field_map_ (""),
   ELtransv_diff_ (0. * mm/sqrt(cm)),
   ELlong_diff_ (0. * mm/sqrt(cm)),
   // EL electric field
@@ -124,6 +126,9 @@ Next100FieldCage::Next100FieldCage():
   drift_long_diff_cmd.SetParameterName("drift_long_diff", true);
   drift_long_diff_cmd.SetUnitCategory("Diffusion");
 
+  msg_->DeclareProperty("drift_field_map", drift_field_map_,
+                        "Map of drift lines in the drift region (uniform field if not given).");
+
   G4GenericMessenger::Command&  ELtransv_diff_cmd =
   msg_->DeclareProperty("ELtransv_diff", ELtransv_diff_,
                         "Tranvsersal diffusion in the EL region");
@@ -324,13 +329,20 @@ void Next100FieldCage::BuildActive()
   G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
   /// Define a drift field for this volume
-  UniformElectricDriftField* field = new UniformElectricDriftField();
-  G4double global_active_zpos = active_zpos_ - GetELzCoord();
-  field->SetCathodePosition(global_active_zpos + active_length_/2.);
-  field->SetAnodePosition(global_active_zpos - active_length_/2.);
-  field->SetDriftVelocity(1. * mm/microsecond);
-  field->SetTransverseDiffusion(drift_transv_diff_);
-  field->SetLongitudinalDiffusion(drift_long_diff_);
+  BaseDriftField* field = nullptr;
+  if (drift_field_map_ != "") {
+    field = new FieldMapDriftField(drift_field_map_);
+  }
+  else {
+    UniformElectricDriftField* uniform_field = new UniformElectricDriftField();
+    G4double global_active_zpos = active_zpos_ - GetELzCoord();
+    uniform_field->SetCathodePosition(global_active_zpos + active_length_/2.);
+    uniform_field->SetAnodePosition(global_active_zpos - active_length_/2.);
+    uniform_field->SetDriftVelocity(1. * mm/microsecond);
+    uniform_field->SetTransverseDiffusion(drift_transv_diff_);
+    uniform_field->SetLongitudinalDiffusion(drift_long_diff_);
+    field = uniform_field;
+  }
   G4Region* drift_region = new G4Region("DRIFT");
   drift_region->SetUserInformation(field);
   drift_region->AddRootLogicalVolume(active_logic);
@@ -61,6 +61,8 @@ namespace nexus {
 
     // Diffusion constants
     G4double drift_transv_diff_, drift_long_diff_;
+    // Drift lines precomputed by a field solver (uniform field if empty)
+    G4String drift_field_map_;
     G4double ELtransv_diff_; ///< transversal diffusion in the EL gap
     G4double ELlong_diff_; ///< longitudinal diffusion in the EL gap
     // Electric field
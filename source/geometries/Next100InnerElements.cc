@@ -11,6 +11,7 @@
 #include "Next100FieldCage.h"
 #include "Next100EnergyPlane.h"
 #include "Next100TrackingPlane.h"
+#include "StartupTimer.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4LogicalVolume.hh>
@@ -67,19 +68,25 @@ namespace nexus {
     field_cage_->SetMotherPhysicalVolume(mother_phys_);
     field_cage_->SetELzCoord(gate_zpos);
     field_cage_->SetELtoSapphireWDWdistance(gate_sapphire_wdw_distance_);
+    StartupTimer::Start("geometry/Next100FieldCage");
     field_cage_->Construct();
+    StartupTimer::Stop("geometry/Next100FieldCage");
 
     // Energy Plane
     energy_plane_->SetMotherLogicalVolume(mother_logic_);
     energy_plane_->SetELzCoord(gate_zpos);
     energy_plane_->SetELtoSapphireWDWdistance(gate_sapphire_wdw_distance_);
+    StartupTimer::Start("geometry/Next100EnergyPlane");
     energy_plane_->Construct();
+    StartupTimer::Stop("geometry/Next100EnergyPlane");
 
     // Tracking plane
     tracking_plane_->SetMotherPhysicalVolume(mother_phys_);
     tracking_plane_->SetELzCoord(gate_zpos);
     tracking_plane_->SetELtoTPdistance(gate_tracking_plane_distance_);
+    StartupTimer::Start("geometry/Next100TrackingPlane");
     tracking_plane_->Construct();
+    StartupTimer::Stop("geometry/Next100TrackingPlane");
   }
 
 
@@ -25,6 +25,7 @@
 #include <G4TransportationManager.hh>
 #include <G4RotationMatrix.hh>
 #include <G4UserLimits.hh>
+#include <G4Region.hh>
 
 #include <CLHEP/Units/SystemOfUnits.h>
 
@@ -234,6 +235,14 @@ namespace nexus {
     new G4PVPlacement(0, G4ThreeVector(0., -steel_thickness_/2., 0.),
                       air_box_logic_, "INNER_AIR", steel_box_logic, false, 0);
 
+    // Regions for the importance biasing of the shielding layers
+    G4Region* lead_region = new G4Region("SHIELDING_LEAD");
+    lead_region->AddRootLogicalVolume(lead_box_logic);
+    G4Region* steel_region = new G4Region("SHIELDING_STEEL");
+    steel_region->AddRootLogicalVolume(steel_box_logic);
+    G4Region* air_region = new G4Region("SHIELDING_AIR");
+    air_region->AddRootLogicalVolume(air_box_logic_);
+
 
     // PEDESTAL BEAMS
     // there are two kind of beams: the support T-shaped beams (support), plain "front" beams (x-direction), plain
@@ -25,6 +25,7 @@
 #include <G4VisAttributes.hh>
 #include <G4UserLimits.hh>
 #include <G4SDManager.hh>
+#include <G4Region.hh>
 
 using namespace nexus;
 
@@ -151,6 +152,10 @@ G4LogicalVolume* NextTonScale::ConstructWaterTank(G4LogicalVolume* mother_logic_
   new G4PVPlacement(nullptr, G4ThreeVector(0.,0.,0.), water_logic_vol,
                     water_name, tank_logic_vol, false, 0, true);
 
+  // Region for the importance biasing of the water shielding
+  G4Region* tank_region = new G4Region("WATER_TANK");
+  tank_region->AddRootLogicalVolume(tank_logic_vol);
+
   //////////////////////////////////////////////////////////
 
   muon_gen_ = new MuonsPointSampler(tank_size_/2. + 50. * cm,
@@ -194,6 +199,10 @@ G4LogicalVolume* NextTonScale::ConstructVesselAndICS(G4LogicalVolume* mother_log
   if (vessel_vis_) vessel_logic_vol->SetVisAttributes(nexus::TitaniumGrey());
   else vessel_logic_vol->SetVisAttributes(G4VisAttributes::GetInvisible());
 
+  // Region for the importance biasing inside the water shielding
+  G4Region* vessel_region = new G4Region("DETECTOR_VESSEL");
+  vessel_region->AddRootLogicalVolume(vessel_logic_vol);
+
   // XENON GAS /////////////////////////////////////////////
   // Xenon gas mixture filling the vessel defined above.
   // The user chooses the mixture and its pressure via configuration parameters.
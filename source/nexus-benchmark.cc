@@ -0,0 +1,11 @@
+// In a Catch project with multiple files, dedicate one file to compile the
+// source code of Catch itself and reuse the resulting object file for linking.
+// Benchmarks are enabled with CATCH_CONFIG_ENABLE_BENCHMARKING, which is
+// defined by the build system for every file of this target.
+
+// Let Catch provide main():
+#define CATCH_CONFIG_MAIN
+
+#include <catch.hpp>
+
+// That's it
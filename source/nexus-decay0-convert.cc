@@ -0,0 +1,29 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-decay0-convert.cc
+//
+// This program converts an event file produced by Decay0 (.genbb) into
+// the binary format read by the Decay0Interface generator.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "Decay0File.h"
+
+#include <G4ios.hh>
+
+#include <cstdlib>
+
+
+int main(int argc, char** argv)
+{
+  if (argc != 3) {
+    G4cerr << "\nUsage: ./nexus-decay0-convert <input.genbb> <output.bin>\n" << G4endl;
+    return EXIT_FAILURE;
+  }
+
+  uint64_t n = nexus::Decay0File::Convert(argv[1], argv[2]);
+  G4cout << "Converted " << n << " events from " << argv[1]
+         << " to " << argv[2] << G4endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-merge.cc
+//
+// This program concatenates nexus h5 output files (for instance, those of
+// the shards of a production) into a single file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HDF5Merger.h"
+
+#include <G4ios.hh>
+
+#include <getopt.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+
+void PrintUsage()
+{
+  G4cerr << "\nUsage: ./nexus-merge [-r] [-f] [-t threads] [-b MB] <output.h5> <input.h5> [<input.h5> ...]\n" << G4endl;
+  G4cerr << "Available options:" << G4endl;
+  G4cerr << "   -r, --renumber        : Shift the event IDs of each file to follow the previous ones\n"
+         << "   -f, --force           : Only warn if the configurations of the files differ\n"
+         << "   -t, --threads         : Number of threads reading the next files ahead\n"
+         << "   -b, --block           : Size in MB of the blocks of rows copied at once"
+         << G4endl;
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char** argv)
+{
+  nexus::HDF5Merger merger;
+
+  static struct option long_options[] =
+  {
+    {"renumber", no_argument,       0, 'r'},
+    {"force",    no_argument,       0, 'f'},
+    {"threads",  required_argument, 0, 't'},
+    {"block",    required_argument, 0, 'b'},
+    {0, 0, 0, 0}
+  };
+
+  int c;
+
+  while (true) {
+
+    c = getopt_long(argc, argv, "rft:b:", long_options, 0);
+
+    if (c==-1) break; // Exit if we are done reading options
+
+    switch (c) {
+
+      case 'r':
+        merger.SetOffsetEvents(true);
+        break;
+
+      case 'f':
+        merger.SetValidateConfiguration(false);
+        break;
+
+      case 't':
+        merger.SetReaderThreads(atoi(optarg));
+        break;
+
+      case 'b':
+        merger.SetBlockSize(size_t(atoi(optarg)) << 20);
+        break;
+
+      default:
+        PrintUsage();
+    }
+  }
+
+  // An output file and at least one input file are needed
+  if (argc - optind < 2) PrintUsage();
+
+  std::vector<std::string> inputs(argv + optind + 1, argv + argc);
+
+  size_t n = merger.Merge(inputs, argv[optind]);
+  G4cout << "Merged " << n << " files into " << argv[optind] << G4endl;
+
+  return EXIT_SUCCESS;
+}
@@ -13,17 +13,19 @@
 #include <G4VisExecutive.hh>
 
 #include <getopt.h>
+#include <algorithm>
 
 using namespace nexus;
 
 
 void PrintUsage()
 {
-  G4cerr  << "\nUsage: ./nexus [-b|i] [-n number] <init_macro>\n" << G4endl;
+  G4cerr  << "\nUsage: ./nexus [-b|i] [-n number] [-s i/N] <init_macro>\n" << G4endl;
   G4cerr  << "Available options:" << G4endl;
   G4cerr  << "   -b, --batch           : Run in batch mode (default)\n"
           << "   -i, --interactive     : Run in interactive mode\n"
-          << "   -n, --nevents         : Number of events to simulate"
+          << "   -n, --nevents         : Number of events to simulate\n"
+          << "   -s, --shard           : Run shard i (from 0) of N of the events"
           << G4endl;
   exit(EXIT_FAILURE);
 }
@@ -40,12 +42,14 @@ G4int main(int argc, char** argv)
 
   G4bool batch = true;
   G4int nevents = 0;
+  G4String shard = "";
 
   static struct option long_options[] =
   {
     {"batch",       no_argument,       0, 'b'},
     {"interactive", no_argument,       0, 'i'},
     {"nevents",       required_argument, 0, 'n'},
+    {"shard",       required_argument, 0, 's'},
     {0, 0, 0, 0}
   };
 
@@ -55,7 +59,7 @@ G4int main(int argc, char** argv)
 
     //  int option_index = 0;
     opterr = 0;
-    c = getopt_long(argc, argv, "bin:", long_options, 0);
+    c = getopt_long(argc, argv, "bin:s:", long_options, 0);
 
     if (c==-1) break; // Exit if we are done reading options
 
@@ -73,6 +77,10 @@ G4int main(int argc, char** argv)
         nevents = atoi(optarg);
         break;
 
+      case 's':
+        shard = optarg;
+        break;
+
       case '?':
         break;
 
@@ -98,10 +106,18 @@ G4int main(int argc, char** argv)
   ////////////////////////////////////////////////////////////////////
 
   NexusApp* app = new NexusApp(macro_filename);
-  app->Initialize();
 
   G4UImanager* UI = G4UImanager::GetUIpointer();
 
+  // The shard must be known before the output file
+  // is opened by the configuration macros
+  if (shard != "") {
+    std::replace(shard.begin(), shard.end(), '/', ' ');
+    UI->ApplyCommand("/nexus/shard " + shard);
+  }
+
+  app->Initialize();
+
   // if (seed < 0) CLHEP::HepRandom::setTheSeed(time(0));
   // else CLHEP::HepRandom::setTheSeed(seed);
 
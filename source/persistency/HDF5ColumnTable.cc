@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5ColumnTable.cc
+//
+// This class writes a table of the h5 nexus output file in columnar
+// layout: a group with one dataset per field of the rows, plus an index
+// with the range of rows of each event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HDF5ColumnTable.h"
+
+#include <cstring>
+
+using namespace nexus;
+
+
+namespace {
+
+  // Rows are written in blocks of the size of the chunks of the datasets
+  const size_t BLOCK_ROWS = 32768;
+
+  void writeRows(hid_t dataset, hid_t memtype, hsize_t counter,
+                 hsize_t n, const void* data)
+  {
+    //Extend dataset
+    hsize_t dims[1] = {counter + n};
+    H5Dset_extent(dataset, dims);
+
+    hid_t memspace = H5Screate_simple(1, &n, NULL);
+    hid_t file_space = H5Dget_space(dataset);
+    hsize_t start[1] = {counter};
+    hsize_t count[1] = {n};
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+    H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+    H5Sclose(file_space);
+    H5Sclose(memspace);
+  }
+
+} // namespace
+
+
+HDF5ColumnTable::HDF5ColumnTable(hid_t parent, std::string table_name, hid_t memtype):
+  buffered_(0), written_(0), index_(nullptr), event_offset_(-1)
+{
+  group_ = createGroup(parent, table_name);
+
+  int n_members = H5Tget_nmembers(memtype);
+  for (int i=0; i<n_members; ++i) {
+    char* name = H5Tget_member_name(memtype, i);
+    std::string column_name = name;
+    H5free_memory(name);
+
+    Column column;
+    column.type   = H5Tget_member_type(memtype, i);
+    column.offset = H5Tget_member_offset(memtype, i);
+    column.size   = H5Tget_size(column.type);
+    column.dataset = createTable(group_, column_name, column.type);
+    column.buffer.reserve(BLOCK_ROWS * column.size);
+    columns_.push_back(column);
+
+    if (column_name == "event_id") event_offset_ = long(column.offset);
+  }
+
+  if (event_offset_ >= 0)
+    index_ = new HDF5EventIndex(group_, "event_index");
+}
+
+HDF5ColumnTable::~HDF5ColumnTable()
+{
+  Flush();
+  delete index_;
+
+  for (auto& column: columns_) {
+    H5Dclose(column.dataset);
+    H5Tclose(column.type);
+  }
+  H5Gclose(group_);
+}
+
+void HDF5ColumnTable::Append(const void* row)
+{
+  const char* data = static_cast<const char*>(row);
+
+  if (index_) {
+    int32_t event_id;
+    memcpy(&event_id, data + event_offset_, sizeof(event_id));
+    index_->Add(event_id, written_ + buffered_);
+  }
+
+  for (auto& column: columns_) {
+    const char* field = data + column.offset;
+    column.buffer.insert(column.buffer.end(), field, field + column.size);
+  }
+
+  if (++buffered_ == BLOCK_ROWS) Flush();
+}
+
+void HDF5ColumnTable::Flush()
+{
+  if (buffered_ > 0) {
+    for (auto& column: columns_) {
+      writeRows(column.dataset, column.type, written_, buffered_,
+                column.buffer.data());
+      column.buffer.clear();
+    }
+    written_ += buffered_;
+    buffered_ = 0;
+  }
+
+  if (index_) index_->Flush();
+}
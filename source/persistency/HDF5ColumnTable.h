@@ -0,0 +1,60 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5ColumnTable.h
+//
+// This class writes a table of the h5 nexus output file in columnar
+// layout: a group with one dataset per field of the rows, plus an index
+// with the range of rows of each event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef HDF5COLUMNTABLE_H
+#define HDF5COLUMNTABLE_H
+
+#include "hdf5_functions.h"
+#include "HDF5EventIndex.h"
+
+#include <hdf5.h>
+#include <string>
+#include <vector>
+
+namespace nexus {
+
+  class HDF5ColumnTable {
+
+  public:
+    /// Create the group of the table in the parent group, with
+    /// one dataset per member of the compound type of the rows
+    HDF5ColumnTable(hid_t parent, std::string table_name, hid_t memtype);
+    /// Write the buffered rows and close the datasets
+    ~HDF5ColumnTable();
+
+    /// Add a row, laid out as in the compound type of the table.
+    /// The rows of an event are expected to be consecutive.
+    void Append(const void* row);
+
+    /// Write the buffered rows
+    void Flush();
+
+  private:
+    struct Column {
+      hid_t dataset;
+      hid_t type;
+      size_t offset; ///< Offset of the field in the rows
+      size_t size;   ///< Size of the field
+      std::vector<char> buffer;
+    };
+
+    hid_t group_;
+    std::vector<Column> columns_;
+
+    size_t buffered_;  ///< Rows in the buffers
+    hsize_t written_;  ///< Rows in the datasets
+
+    HDF5EventIndex* index_;
+    long event_offset_; ///< Offset of the event ID in the rows (or -1)
+  };
+
+} // namespace nexus
+
+#endif
@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5EventIndex.cc
+//
+// This class writes the index of a table of the h5 nexus output file:
+// the event ID, first row and number of rows of each event, so that
+// readers can seek the rows of an event without scanning the table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HDF5EventIndex.h"
+
+using namespace nexus;
+
+
+namespace {
+
+  // Entries are written in blocks, rather than one by one
+  const size_t BLOCK_ENTRIES = 1024;
+
+} // namespace
+
+
+HDF5EventIndex::HDF5EventIndex(hid_t parent, std::string index_name):
+  counter_(0)
+{
+  memtype_ = createEventIndexType();
+  dataset_ = createTable(parent, index_name, memtype_);
+
+  current_.event_id  = -1;
+  current_.first_row = 0;
+  current_.n_rows    = 0;
+}
+
+HDF5EventIndex::~HDF5EventIndex()
+{
+  // The last event is complete once the table is closed
+  if (current_.n_rows > 0) buffer_.push_back(current_);
+  current_.n_rows = 0;
+  Flush();
+
+  H5Dclose(dataset_);
+  H5Tclose(memtype_);
+}
+
+void HDF5EventIndex::Add(int32_t event_id, hsize_t row)
+{
+  if (current_.n_rows == 0 || event_id != current_.event_id) {
+    if (current_.n_rows > 0) buffer_.push_back(current_);
+    current_.event_id  = event_id;
+    current_.first_row = row;
+    current_.n_rows    = 0;
+    if (buffer_.size() >= BLOCK_ENTRIES) Flush();
+  }
+  current_.n_rows++;
+}
+
+void HDF5EventIndex::Flush()
+{
+  if (buffer_.empty()) return;
+
+  hsize_t n = buffer_.size();
+
+  //Extend dataset
+  hsize_t dims[1] = {counter_ + n};
+  H5Dset_extent(dataset_, dims);
+
+  hid_t memspace = H5Screate_simple(1, &n, NULL);
+  hid_t file_space = H5Dget_space(dataset_);
+  hsize_t start[1] = {counter_};
+  hsize_t count[1] = {n};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset_, memtype_, memspace, file_space, H5P_DEFAULT, buffer_.data());
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+
+  counter_ += n;
+  buffer_.clear();
+}
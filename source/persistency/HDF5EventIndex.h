@@ -0,0 +1,47 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5EventIndex.h
+//
+// This class writes the index of a table of the h5 nexus output file:
+// the event ID, first row and number of rows of each event, so that
+// readers can seek the rows of an event without scanning the table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef HDF5EVENTINDEX_H
+#define HDF5EVENTINDEX_H
+
+#include "hdf5_functions.h"
+
+#include <hdf5.h>
+#include <string>
+#include <vector>
+
+namespace nexus {
+
+  class HDF5EventIndex {
+
+  public:
+    /// Create the index dataset in the parent group
+    HDF5EventIndex(hid_t parent, std::string index_name);
+    /// Write the last event and close the dataset
+    ~HDF5EventIndex();
+
+    /// Account for a new row of the table, with the given event ID.
+    /// The rows of an event are expected to be consecutive.
+    void Add(int32_t event_id, hsize_t row);
+
+    /// Write the buffered entries of the completed events
+    void Flush();
+
+  private:
+    hid_t dataset_;
+    hid_t memtype_;
+    event_index_t current_; ///< Rows of the current event
+    std::vector<event_index_t> buffer_;
+    hsize_t counter_; ///< Entries in the dataset
+  };
+
+} // namespace nexus
+
+#endif
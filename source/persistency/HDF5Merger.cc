@@ -0,0 +1,525 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5Merger.cc
+//
+// This class concatenates nexus h5 output files (for instance, those of
+// the shards of a production) into a single file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HDF5Merger.h"
+
+#include <G4Exception.hh>
+#include <G4String.hh>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+using namespace nexus;
+
+
+namespace {
+
+  // Configuration entries that are expected to differ between files
+  bool IsJobSpecific(const std::string& key)
+  {
+    return key.compare(0, 10, "init_time/") == 0 ||
+      key.compare(0, 6, "shard_") == 0 ||
+      key == "num_events" || key == "saved_events" ||
+      key == "interacting_events" || key == "random_seed" ||
+      key == "/nexus/persistency/outputFile" ||
+      key == "/nexus/persistency/start_id" ||
+      key == "/nexus/random_seed" || key == "/nexus/shard";
+  }
+
+  // Event counters summed over the files
+  bool IsEventCounter(const std::string& key)
+  {
+    return key == "num_events" || key == "saved_events" ||
+      key == "interacting_events";
+  }
+
+  hsize_t NumberOfRows(hid_t table)
+  {
+    hid_t space = H5Dget_space(table);
+    hsize_t n = 0;
+    H5Sget_simple_extent_dims(space, &n, NULL);
+    H5Sclose(space);
+    return n;
+  }
+
+  // Byte offset of the event ID in the rows of a table, or -1
+  long EventIDOffset(hid_t type)
+  {
+    int index = H5Tget_member_index(type, "event_id");
+    if (index < 0) return -1;
+
+    hid_t member = H5Tget_member_type(type, index);
+    bool is_int32 = H5Tequal(member, H5T_NATIVE_INT32) > 0;
+    H5Tclose(member);
+    if (!is_int32)
+      G4Exception("[HDF5Merger]", "EventIDOffset()", FatalException,
+                  "Unexpected type of the event_id column.");
+
+    return long(H5Tget_member_offset(type, index));
+  }
+
+  void ReadRows(hid_t table, hid_t memtype, hsize_t first, hsize_t n, void* buffer)
+  {
+    hid_t memspace = H5Screate_simple(1, &n, NULL);
+    hid_t file_space = H5Dget_space(table);
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &first, NULL, &n, NULL);
+    H5Dread(table, memtype, memspace, file_space, H5P_DEFAULT, buffer);
+    H5Sclose(file_space);
+    H5Sclose(memspace);
+  }
+
+  void AppendRows(hid_t table, hid_t memtype, hsize_t n, const void* buffer)
+  {
+    hsize_t counter = NumberOfRows(table);
+
+    //Extend dataset
+    hsize_t dims[1] = {counter + n};
+    H5Dset_extent(table, dims);
+
+    hid_t memspace = H5Screate_simple(1, &n, NULL);
+    hid_t file_space = H5Dget_space(table);
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &counter, NULL, &n, NULL);
+    H5Dwrite(table, memtype, memspace, file_space, H5P_DEFAULT, buffer);
+    H5Sclose(file_space);
+    H5Sclose(memspace);
+  }
+
+} // namespace
+
+
+HDF5Merger::HDF5Merger():
+  file_(-1), offset_events_(false), validate_(true), threads_(0),
+  block_size_(64 << 20), next_event_(0), next_read_(0), current_(0)
+{
+}
+
+HDF5Merger::~HDF5Merger()
+{
+}
+
+size_t HDF5Merger::Merge(const std::vector<std::string>& inputs,
+                         const std::string& output)
+{
+  file_ = H5Fcreate(output.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file_ < 0)
+    G4Exception("[HDF5Merger]", "Merge()", FatalException,
+                ("Cannot create " + output).c_str());
+
+  // The HDF5 library serializes all its calls, so reading the tables in
+  // several threads would not help. Instead, the reader threads read the
+  // next input files ahead (outside HDF5) while the current one is merged.
+  next_read_ = 1;
+  current_ = 0;
+  std::vector<std::thread> readers;
+  for (unsigned int t=0; t<threads_; ++t)
+    readers.emplace_back(&HDF5Merger::ReadAhead, this, std::cref(inputs));
+
+  for (size_t i=0; i<inputs.size(); ++i) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      current_ = i;
+    }
+    cv_.notify_all();
+
+    hid_t input = H5Fopen(inputs[i].c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (input < 0)
+      G4Exception("[HDF5Merger]", "Merge()", FatalException,
+                  ("Cannot open " + inputs[i]).c_str());
+
+    if (H5Lexists(input, "/MC/configuration", H5P_DEFAULT) > 0) {
+      hid_t config = H5Dopen(input, "/MC/configuration", H5P_DEFAULT);
+      MergeConfiguration(config, inputs[i]);
+      H5Dclose(config);
+    }
+
+    rows_before_.clear();
+    for (auto& table: tables_) rows_before_[table.first] = NumberOfRows(table.second);
+
+    int offset = offset_events_ ? EventOffset(input) : 0;
+    MergeGroup(input, "/MC", offset);
+    MergeGroup(input, "/DEBUG", offset);
+
+    H5Fclose(input);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_ = inputs.size();
+  }
+  cv_.notify_all();
+  for (auto& reader: readers) reader.join();
+
+  WriteConfiguration();
+
+  for (auto& table: tables_) H5Dclose(table.second);
+  tables_.clear();
+  H5Fclose(file_);
+
+  return inputs.size();
+}
+
+void HDF5Merger::ReadAhead(const std::vector<std::string>& inputs)
+{
+  std::vector<char> buffer(16 << 20);
+
+  while (true) {
+    size_t i = next_read_++;
+    if (i >= inputs.size()) return;
+
+    // Stay at most as many files ahead as reader threads
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&]{ return i <= current_ + threads_; });
+      if (current_ >= inputs.size()) return;
+      if (i <= current_) continue; // already opened by HDF5
+    }
+
+    std::ifstream file(inputs[i], std::ios::binary);
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {}
+  }
+}
+
+int HDF5Merger::EventOffset(hid_t input)
+{
+  // Range of (non-negative) event IDs in the tables of the file
+  long min_id = LONG_MAX, max_id = -1;
+
+  if (H5Lexists(input, "/MC", H5P_DEFAULT) > 0) {
+    hid_t group = H5Gopen(input, "/MC", H5P_DEFAULT);
+    EventRange(group, min_id, max_id);
+    H5Gclose(group);
+  }
+
+  if (max_id < 0) return 0;
+
+  int offset = next_event_ - int(min_id);
+  next_event_ += int(max_id - min_id) + 1;
+  return offset;
+}
+
+void HDF5Merger::EventRange(hid_t group, long& min_id, long& max_id)
+{
+  H5G_info_t info;
+  H5Gget_info(group, &info);
+
+  for (hsize_t i=0; i<info.nlinks; ++i) {
+    char name[256];
+    H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i,
+                       name, sizeof(name), H5P_DEFAULT);
+    hid_t object = H5Oopen(group, name, H5P_DEFAULT);
+    if (object < 0) continue;
+
+    // Tables in columnar layout are groups
+    if (H5Iget_type(object) == H5I_GROUP) {
+      EventRange(object, min_id, max_id);
+      H5Oclose(object);
+      continue;
+    }
+
+    // Only the event IDs are read, either from the event_id
+    // member of the rows or from an event_id column
+    hid_t type = H5Dget_type(object);
+    hid_t memtype = -1;
+    if (H5Tget_class(type) == H5T_COMPOUND && EventIDOffset(type) >= 0) {
+      memtype = H5Tcreate(H5T_COMPOUND, sizeof(int32_t));
+      H5Tinsert(memtype, "event_id", 0, H5T_NATIVE_INT32);
+    }
+    else if (std::string(name) == "event_id") {
+      memtype = H5Tcopy(H5T_NATIVE_INT32);
+    }
+    H5Tclose(type);
+
+    hsize_t n = NumberOfRows(object);
+    if (memtype >= 0 && n > 0) {
+      hsize_t block = std::max<hsize_t>(1, block_size_ / sizeof(int32_t));
+      std::vector<int32_t> ids(std::min(n, block));
+      for (hsize_t first=0; first<n; first+=block) {
+        hsize_t count = std::min(block, n - first);
+        ReadRows(object, memtype, first, count, ids.data());
+        for (hsize_t j=0; j<count; ++j) {
+          if (ids[j] < 0) continue;
+          min_id = std::min(min_id, long(ids[j]));
+          max_id = std::max(max_id, long(ids[j]));
+        }
+      }
+    }
+    if (memtype >= 0) H5Tclose(memtype);
+    H5Oclose(object);
+  }
+}
+
+void HDF5Merger::MergeGroup(hid_t input, const std::string& group_name, int offset,
+                            const std::string& indexed_group)
+{
+  if (H5Lexists(input, group_name.c_str(), H5P_DEFAULT) <= 0) return;
+
+  hid_t group = H5Gopen(input, group_name.c_str(), H5P_DEFAULT);
+
+  if (H5Lexists(file_, group_name.c_str(), H5P_DEFAULT) <= 0) {
+    hid_t out_group = H5Gcreate(file_, group_name.c_str(),
+                                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Gclose(out_group);
+  }
+
+  H5G_info_t info;
+  H5Gget_info(group, &info);
+
+  std::vector<std::string> names;
+  for (hsize_t i=0; i<info.nlinks; ++i) {
+    char name[256];
+    H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i,
+                       name, sizeof(name), H5P_DEFAULT);
+    names.push_back(name);
+  }
+
+  for (const auto& name: names) {
+    std::string path = group_name + "/" + name;
+
+    // The configuration is written once all the files are merged
+    if (path == "/MC/configuration") continue;
+
+    hid_t object = H5Oopen(group, name.c_str(), H5P_DEFAULT);
+    if (object < 0) continue;
+
+    if (H5Iget_type(object) == H5I_GROUP) {
+      H5Oclose(object);
+      // Group of the indexes of the tables in row layout
+      if (name == "event_index") MergeGroup(input, path, offset, group_name);
+      else                       MergeGroup(input, path, offset);
+      continue;
+    }
+
+    hid_t out_table = GetOutputTable(object, path);
+    if (path == "/MC/sns_positions") {
+      AppendSensorPositions(object, out_table);
+    }
+    else {
+      // Rows of the output that the rows of the table refer to:
+      // those of the indexed tables, or of the waveform values
+      std::string target;
+      if (!indexed_group.empty())      target = indexed_group + "/" + name;
+      else if (name == "event_index") target = group_name + "/event_id";
+      else if (path == "/MC/sns_waveforms" || group_name == "/MC/sns_waveforms")
+        target = "/MC/sns_waveform_values";
+      auto it = rows_before_.find(target);
+      hsize_t row_offset = (it != rows_before_.end()) ? it->second : 0;
+
+      AppendTable(object, out_table, name, offset, row_offset);
+    }
+
+    H5Oclose(object);
+  }
+
+  H5Gclose(group);
+}
+
+hid_t HDF5Merger::GetOutputTable(hid_t input_table, const std::string& path)
+{
+  auto it = tables_.find(path);
+  if (it != tables_.end()) return it->second;
+
+  // Same row type, chunking and filters as the input table
+  hid_t type  = H5Dget_type(input_table);
+  hid_t plist = H5Dget_create_plist(input_table);
+
+  const hsize_t ndims = 1;
+  hsize_t dims[ndims] = {0};
+  hsize_t max_dims[ndims] = {H5S_UNLIMITED};
+  hid_t file_space = H5Screate_simple(ndims, dims, max_dims);
+
+  hid_t table = H5Dcreate(file_, path.c_str(), type, file_space,
+                          H5P_DEFAULT, plist, H5P_DEFAULT);
+
+  H5Sclose(file_space);
+  H5Pclose(plist);
+  H5Tclose(type);
+
+  tables_[path] = table;
+  return table;
+}
+
+void HDF5Merger::AppendTable(hid_t input_table, hid_t output_table,
+                             const std::string& name, int offset, hsize_t row_offset)
+{
+  hsize_t n_rows = NumberOfRows(input_table);
+  if (n_rows == 0) return;
+
+  // The rows are copied as they are stored in the file, with no
+  // conversion, in blocks of at most block_size_ bytes
+  hid_t type = H5Dget_type(input_table);
+  size_t row_size = H5Tget_size(type);
+  long id_offset = -1;
+  long output_id_offset = -1; // event_stats refers to the IDs of the other tables
+  if (offset) {
+    if (H5Tget_class(type) == H5T_COMPOUND) {
+      id_offset = EventIDOffset(type);
+      int index = H5Tget_member_index(type, "output_id");
+      if (index >= 0) output_id_offset = long(H5Tget_member_offset(type, index));
+    }
+    else if (name == "event_id" || name == "output_id") id_offset = 0;
+  }
+
+  // First rows of the events in an event index, or first values
+  // of the sparse waveforms
+  long first_row_offset = -1;
+  if (row_offset > 0) {
+    if (H5Tget_class(type) != H5T_COMPOUND) {
+      if (name == "first_value") first_row_offset = 0;
+    }
+    else {
+      int index = H5Tget_member_index(type, "first_row");
+      if (index < 0) index = H5Tget_member_index(type, "first_value");
+      if (index >= 0) first_row_offset = long(H5Tget_member_offset(type, index));
+    }
+  }
+
+  hsize_t block = std::max<hsize_t>(1, block_size_ / row_size);
+  std::vector<char> buffer(std::min(n_rows, block) * row_size);
+
+  for (hsize_t first=0; first<n_rows; first+=block) {
+    hsize_t count = std::min(block, n_rows - first);
+    ReadRows(input_table, type, first, count, buffer.data());
+
+    for (long field_offset: {id_offset, output_id_offset}) {
+      if (field_offset < 0) continue;
+      for (hsize_t j=0; j<count; ++j) {
+        char* field = buffer.data() + j * row_size + field_offset;
+        int32_t id;
+        std::memcpy(&id, field, sizeof(id));
+        if (id < 0) continue; // discarded events
+        id += offset;
+        std::memcpy(field, &id, sizeof(id));
+      }
+    }
+
+    if (first_row_offset >= 0) {
+      for (hsize_t j=0; j<count; ++j) {
+        char* field = buffer.data() + j * row_size + first_row_offset;
+        uint64_t first_row;
+        std::memcpy(&first_row, field, sizeof(first_row));
+        first_row += row_offset;
+        std::memcpy(field, &first_row, sizeof(first_row));
+      }
+    }
+
+    AppendRows(output_table, type, count, buffer.data());
+  }
+
+  H5Tclose(type);
+}
+
+void HDF5Merger::AppendSensorPositions(hid_t input_table, hid_t output_table)
+{
+  hsize_t n_rows = NumberOfRows(input_table);
+  if (n_rows == 0) return;
+
+  hid_t memtype = createSensorPosType();
+  std::vector<sns_pos_t> rows(n_rows);
+  ReadRows(input_table, memtype, 0, n_rows, rows.data());
+
+  // Every file lists the same sensors: only new ones are written
+  std::vector<sns_pos_t> new_rows;
+  for (const auto& row: rows) {
+    auto it = sensor_pos_.find(row.sensor_id);
+    if (it == sensor_pos_.end()) {
+      sensor_pos_[row.sensor_id] = row;
+      new_rows.push_back(row);
+    }
+    else if (it->second.x != row.x || it->second.y != row.y ||
+             it->second.z != row.z) {
+      G4String msg = "Sensor " + std::to_string(row.sensor_id) +
+        " has different positions in different files.";
+      G4Exception("[HDF5Merger]", "AppendSensorPositions()", JustWarning, msg);
+    }
+  }
+
+  if (!new_rows.empty())
+    AppendRows(output_table, memtype, new_rows.size(), new_rows.data());
+
+  H5Tclose(memtype);
+}
+
+void HDF5Merger::MergeConfiguration(hid_t input_table, const std::string& filename)
+{
+  hsize_t n_rows = NumberOfRows(input_table);
+  hid_t memtype = createRunType();
+  std::vector<run_info_t> rows(n_rows);
+  if (n_rows > 0) ReadRows(input_table, memtype, 0, n_rows, rows.data());
+  H5Tclose(memtype);
+
+  for (const auto& row: rows) {
+    if (IsEventCounter(row.param_key))
+      counters_[row.param_key] += std::atol(row.param_value);
+  }
+
+  if (config_.empty()) {
+    config_ = rows;
+    return;
+  }
+
+  std::map<std::string, std::string> reference, current;
+  for (const auto& row: config_)
+    if (!IsJobSpecific(row.param_key)) reference[row.param_key] = row.param_value;
+  for (const auto& row: rows)
+    if (!IsJobSpecific(row.param_key)) current[row.param_key] = row.param_value;
+
+  if (current == reference) return;
+
+  G4String msg = "The configuration of " + filename + " differs from that of the first file:";
+  for (const auto& entry: reference) {
+    auto it = current.find(entry.first);
+    if (it == current.end() || it->second != entry.second)
+      msg += "\n  " + entry.first;
+  }
+  for (const auto& entry: current) {
+    if (reference.find(entry.first) == reference.end())
+      msg += "\n  " + entry.first;
+  }
+
+  G4Exception("[HDF5Merger]", "MergeConfiguration()",
+              validate_ ? FatalException : JustWarning, msg);
+}
+
+void HDF5Merger::WriteConfiguration()
+{
+  if (config_.empty()) return;
+
+  if (H5Lexists(file_, "/MC", H5P_DEFAULT) <= 0) {
+    hid_t group = H5Gcreate(file_, "/MC", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Gclose(group);
+  }
+
+  // Configuration of the first file, with the event counters summed
+  // over all the files and without the range of events of its shard
+  std::vector<run_info_t> rows;
+  for (auto row: config_) {
+    std::string key = row.param_key;
+    if (key == "shard_index" || key == "shard_first_event" ||
+        key == "shard_num_events")
+      continue;
+    if (IsEventCounter(key)) {
+      std::string value = std::to_string(counters_[key]);
+      std::strncpy(row.param_value, value.c_str(), CONFLEN - 1);
+      row.param_value[CONFLEN - 1] = '\0';
+    }
+    rows.push_back(row);
+  }
+
+  hid_t group = H5Gopen(file_, "/MC", H5P_DEFAULT);
+  std::string table_name = "configuration";
+  hid_t memtype = createRunType();
+  hid_t table = createTable(group, table_name, memtype);
+  AppendRows(table, memtype, rows.size(), rows.data());
+  H5Dclose(table);
+  H5Tclose(memtype);
+  H5Gclose(group);
+}
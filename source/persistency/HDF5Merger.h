@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+// nexus | HDF5Merger.h
+//
+// This class concatenates nexus h5 output files (for instance, those of
+// the shards of a production) into a single file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef HDF5MERGER_H
+#define HDF5MERGER_H
+
+#include "hdf5_functions.h"
+
+#include <hdf5.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nexus {
+
+  class HDF5Merger {
+
+  public:
+    /// constructor
+    HDF5Merger();
+    /// destructor
+    ~HDF5Merger();
+
+    /// Concatenate the tables of the input files into the output file.
+    /// Returns the number of input files merged.
+    size_t Merge(const std::vector<std::string>& inputs, const std::string& output);
+
+    /// Shift the event IDs of each file so that they follow those
+    /// of the previous files (false by default)
+    void SetOffsetEvents(bool);
+    /// Abort if the configuration of a file differs from that of the
+    /// first one (true by default). Otherwise, only warn.
+    void SetValidateConfiguration(bool);
+    /// Number of threads reading ahead the next input files (default 0)
+    void SetReaderThreads(unsigned int);
+    /// Maximum size in bytes of the blocks of rows copied at once
+    void SetBlockSize(size_t);
+
+  private:
+    /// Append the tables of a group of an input file to the output.
+    /// For a group of event indexes, indexed_group is the group of
+    /// the tables they refer to.
+    void MergeGroup(hid_t input, const std::string& group_name, int offset,
+                    const std::string& indexed_group="");
+    /// Append all the rows of an input table (or column) to the output
+    /// table in blocks, shifting the event IDs by offset and the first
+    /// rows of an event index (or sparse waveforms) by row_offset
+    void AppendTable(hid_t input_table, hid_t output_table,
+                     const std::string& name, int offset, hsize_t row_offset);
+    /// Append the sensors of the input table not seen yet
+    void AppendSensorPositions(hid_t input_table, hid_t output_table);
+    /// Compare the configuration of an input file with that of the
+    /// first one and accumulate the event counters
+    void MergeConfiguration(hid_t input_table, const std::string& filename);
+    /// Write the merged configuration table
+    void WriteConfiguration();
+    /// Offset that makes the event IDs of a file follow the previous ones
+    int EventOffset(hid_t input);
+    /// Range of the event IDs in the tables of a group
+    void EventRange(hid_t group, long& min_id, long& max_id);
+    /// Output table with the same type and layout as the input one
+    hid_t GetOutputTable(hid_t input_table, const std::string& path);
+
+    /// Read ahead the input files, warming the page cache
+    void ReadAhead(const std::vector<std::string>& inputs);
+
+  private:
+    hid_t file_; ///< Output file
+
+    bool offset_events_;
+    bool validate_;
+    unsigned int threads_;
+    size_t block_size_;
+
+    std::map<std::string, hid_t> tables_; ///< Output tables by path
+    std::map<std::string, hsize_t> rows_before_; ///< Rows of the output tables before the current file
+
+    int next_event_; ///< First event ID available for the next file
+
+    std::map<unsigned int, sns_pos_t> sensor_pos_; ///< Sensors already written
+
+    std::vector<run_info_t> config_; ///< Configuration of the first file
+    std::map<std::string, long> counters_; ///< Summed event counters
+
+    // Read-ahead of the input files
+    std::atomic<size_t> next_read_; ///< Next file to be read ahead
+    size_t current_; ///< File being merged
+    std::mutex mutex_;
+    std::condition_variable cv_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline void HDF5Merger::SetOffsetEvents(bool o) { offset_events_ = o; }
+  inline void HDF5Merger::SetValidateConfiguration(bool v) { validate_ = v; }
+  inline void HDF5Merger::SetReaderThreads(unsigned int n) { threads_ = n; }
+  inline void HDF5Merger::SetBlockSize(size_t s) { block_size_ = s; }
+
+} // namespace nexus
+
+#endif
@@ -20,8 +20,22 @@ using namespace nexus;
 
 
 HDF5Writer::HDF5Writer():
-  file_(0), irun_(0), ismp_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0)
+  file_(0), group_(0), eventStatsTable_(0), eventWeightTable_(0),
+  particleWeightTable_(0), hitWeightTable_(0), snsWaveformTable_(0),
+  snsWaveformValues_(0), indexGroup_(0),
+  snsDataIndex_(nullptr), hitInfoIndex_(nullptr),
+  particleInfoIndex_(nullptr), stepIndex_(nullptr),
+  eventStatsIndex_(nullptr), eventWeightIndex_(nullptr),
+  particleWeightIndex_(nullptr), hitWeightIndex_(nullptr),
+  snsWaveformIndex_(nullptr),
+  snsDataColumns_(nullptr), hitInfoColumns_(nullptr),
+  particleInfoColumns_(nullptr), stepColumns_(nullptr),
+  eventStatsColumns_(nullptr), eventWeightColumns_(nullptr),
+  particleWeightColumns_(nullptr), hitWeightColumns_(nullptr),
+  snsWaveformColumns_(nullptr),
+  irun_(0), ismp_(0), ihit_(0),
+  ipart_(0), ipos_(0), istep_(0), istats_(0), iweight_(0), ipartweight_(0),
+  ihitweight_(0), iwvf_(0), iwvfval_(0)
 {
 }
 
@@ -29,15 +43,22 @@ HDF5Writer::~HDF5Writer()
 {
 }
 
-void HDF5Writer::Open(std::string fileName, bool debug)
+void HDF5Writer::Open(std::string fileName, bool debug, bool columnar)
 {
   firstEvent_= true;
+  columnar_ = columnar;
 
   file_ = H5Fcreate( fileName.c_str(), H5F_ACC_TRUNC,
                       H5P_DEFAULT, H5P_DEFAULT );
 
   std::string group_name = "/MC";
   size_t group = createGroup(file_, group_name);
+  group_ = group;
+
+  if (!columnar_) {
+    std::string index_group_name = "/MC/event_index";
+    indexGroup_ = createGroup(file_, index_group_name);
+  }
 
   std::string run_table_name = "configuration";
   memtypeRun_ = createRunType();
@@ -45,15 +66,30 @@ void HDF5Writer::Open(std::string fileName, bool debug)
 
   std::string sns_data_table_name = "sns_response";
   memtypeSnsData_ = createSensorDataType();
-  snsDataTable_ = createTable(group, sns_data_table_name, memtypeSnsData_);
+  if (columnar_)
+    snsDataColumns_ = new HDF5ColumnTable(group, sns_data_table_name, memtypeSnsData_);
+  else {
+    snsDataTable_ = createTable(group, sns_data_table_name, memtypeSnsData_);
+    snsDataIndex_ = new HDF5EventIndex(indexGroup_, sns_data_table_name);
+  }
 
   std::string hit_info_table_name = "hits";
   memtypeHitInfo_ = createHitInfoType();
-  hitInfoTable_ = createTable(group, hit_info_table_name, memtypeHitInfo_);
+  if (columnar_)
+    hitInfoColumns_ = new HDF5ColumnTable(group, hit_info_table_name, memtypeHitInfo_);
+  else {
+    hitInfoTable_ = createTable(group, hit_info_table_name, memtypeHitInfo_);
+    hitInfoIndex_ = new HDF5EventIndex(indexGroup_, hit_info_table_name);
+  }
 
   std::string particle_info_table_name = "particles";
   memtypeParticleInfo_ = createParticleInfoType();
-  particleInfoTable_ = createTable(group, particle_info_table_name, memtypeParticleInfo_);
+  if (columnar_)
+    particleInfoColumns_ = new HDF5ColumnTable(group, particle_info_table_name, memtypeParticleInfo_);
+  else {
+    particleInfoTable_ = createTable(group, particle_info_table_name, memtypeParticleInfo_);
+    particleInfoIndex_ = new HDF5EventIndex(indexGroup_, particle_info_table_name);
+  }
 
   std::string sns_pos_table_name = "sns_positions";
   memtypeSnsPos_ = createSensorPosType();
@@ -64,7 +100,15 @@ void HDF5Writer::Open(std::string fileName, bool debug)
     size_t debug_group = createGroup(file_, debug_group_name);
     std::string step_table_name = "steps";
     memtypeStep_ = createStepType();
-    stepTable_   = createTable(debug_group, step_table_name, memtypeStep_);
+    if (columnar_)
+      stepColumns_ = new HDF5ColumnTable(debug_group, step_table_name, memtypeStep_);
+    else {
+      stepTable_ = createTable(debug_group, step_table_name, memtypeStep_);
+      std::string debug_index_group_name = "/DEBUG/event_index";
+      size_t debug_index_group = createGroup(file_, debug_index_group_name);
+      stepIndex_ = new HDF5EventIndex(debug_index_group, step_table_name);
+      H5Gclose(debug_index_group);
+    }
   }
 
   isOpen_ = true;
@@ -72,6 +116,34 @@ void HDF5Writer::Open(std::string fileName, bool debug)
 
 void HDF5Writer::Close()
 {
+  // Write the rows still buffered by the columnar tables
+  delete snsDataColumns_;
+  delete hitInfoColumns_;
+  delete particleInfoColumns_;
+  delete stepColumns_;
+  delete eventStatsColumns_;
+  delete eventWeightColumns_;
+  delete particleWeightColumns_;
+  delete hitWeightColumns_;
+  delete snsWaveformColumns_;
+  snsDataColumns_ = hitInfoColumns_ = particleInfoColumns_ = stepColumns_ = nullptr;
+  eventStatsColumns_ = eventWeightColumns_ = nullptr;
+  particleWeightColumns_ = hitWeightColumns_ = snsWaveformColumns_ = nullptr;
+
+  // and the entries of the last events of the indexes
+  delete snsDataIndex_;
+  delete hitInfoIndex_;
+  delete particleInfoIndex_;
+  delete stepIndex_;
+  delete eventStatsIndex_;
+  delete eventWeightIndex_;
+  delete particleWeightIndex_;
+  delete hitWeightIndex_;
+  delete snsWaveformIndex_;
+  snsDataIndex_ = hitInfoIndex_ = particleInfoIndex_ = stepIndex_ = nullptr;
+  eventStatsIndex_ = eventWeightIndex_ = nullptr;
+  particleWeightIndex_ = hitWeightIndex_ = snsWaveformIndex_ = nullptr;
+
   isOpen_=false;
   H5Fclose(file_);
 }
@@ -96,11 +168,50 @@ void HDF5Writer::WriteSensorDataInfo(int evt_number, unsigned int sensor_id, uns
   snsData.sensor_id = sensor_id;
   snsData.time_bin = time_bin;
   snsData.charge = charge;
-  writeSnsData(&snsData, snsDataTable_, memtypeSnsData_, ismp_);
+  if (columnar_) snsDataColumns_->Append(&snsData);
+  else {
+    writeSnsData(&snsData, snsDataTable_, memtypeSnsData_, ismp_);
+    snsDataIndex_->Add(evt_number, ismp_);
+  }
 
   ismp_++;
 }
 
+void HDF5Writer::WriteSensorWaveform(int evt_number, unsigned int sensor_id, unsigned int start_bin, const std::vector<uint16_t>& values)
+{
+  // The tables are optional, so they are only created when first needed
+  if (!snsWaveformTable_ && !snsWaveformColumns_) {
+    std::string sns_waveform_table_name = "sns_waveforms";
+    memtypeSnsWaveform_ = createSensorWaveformType();
+    if (columnar_)
+      snsWaveformColumns_ = new HDF5ColumnTable(group_, sns_waveform_table_name, memtypeSnsWaveform_);
+    else {
+      snsWaveformTable_ = createTable(group_, sns_waveform_table_name, memtypeSnsWaveform_);
+      snsWaveformIndex_ = new HDF5EventIndex(indexGroup_, sns_waveform_table_name);
+    }
+
+    std::string sns_waveform_values_name = "sns_waveform_values";
+    snsWaveformValues_ = createTable(group_, sns_waveform_values_name, H5T_NATIVE_UINT16);
+  }
+
+  sns_waveform_t wvf;
+  wvf.event_id    = evt_number;
+  wvf.sensor_id   = sensor_id;
+  wvf.start_bin   = start_bin;
+  wvf.n_values    = values.size();
+  wvf.first_value = iwvfval_;
+  if (columnar_) snsWaveformColumns_->Append(&wvf);
+  else {
+    writeSnsWaveform(&wvf, snsWaveformTable_, memtypeSnsWaveform_, iwvf_);
+    snsWaveformIndex_->Add(evt_number, iwvf_);
+  }
+
+  writeSnsWaveformValues(values.data(), values.size(), snsWaveformValues_, iwvfval_);
+
+  iwvf_++;
+  iwvfval_ += values.size();
+}
+
 void HDF5Writer::WriteHitInfo(int evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label)
 {
   hit_info_t trueInfo;
@@ -114,7 +225,11 @@ void HDF5Writer::WriteHitInfo(int evt_number, int particle_indx, int hit_indx, f
   strcpy(trueInfo.label, label);
   trueInfo.particle_id = particle_indx;
   trueInfo.hit_id = hit_indx;
-  writeHit(&trueInfo,  hitInfoTable_, memtypeHitInfo_, ihit_);
+  if (columnar_) hitInfoColumns_->Append(&trueInfo);
+  else {
+    writeHit(&trueInfo,  hitInfoTable_, memtypeHitInfo_, ihit_);
+    hitInfoIndex_->Add(evt_number, ihit_);
+  }
 
   ihit_++;
 }
@@ -152,7 +267,11 @@ void HDF5Writer::WriteParticleInfo(int evt_number, int particle_indx, const char
   strcpy(trueInfo.creator_proc, creator_proc);
   memset(trueInfo.final_proc, 0, STRLEN);
   strcpy(trueInfo.final_proc, final_proc);
-  writeParticle(&trueInfo,  particleInfoTable_, memtypeParticleInfo_, ipart_);
+  if (columnar_) particleInfoColumns_->Append(&trueInfo);
+  else {
+    writeParticle(&trueInfo,  particleInfoTable_, memtypeParticleInfo_, ipart_);
+    particleInfoIndex_->Add(evt_number, ipart_);
+  }
 
   ipart_++;
 }
@@ -199,7 +318,131 @@ void HDF5Writer::WriteStep(int evt_number,
   step.  final_y   =   final_y;
   step.  final_z   =   final_z;
 
-  writeStep(&step, stepTable_, memtypeStep_, istep_);
+  if (columnar_) stepColumns_->Append(&step);
+  else {
+    writeStep(&step, stepTable_, memtypeStep_, istep_);
+    stepIndex_->Add(evt_number, istep_);
+  }
 
   istep_++;
 }
+
+void HDF5Writer::WriteEventStats(int evt_number, int output_id, uint64_t steps,
+                                 uint64_t el_photons, uint64_t scint_photons,
+                                 uint64_t ie, uint64_t detected_photons,
+                                 float wall_time, float cpu_time)
+{
+  // The table is optional, so it is only created when first needed
+  if (!eventStatsTable_ && !eventStatsColumns_) {
+    std::string event_stats_table_name = "event_stats";
+    memtypeEventStats_ = createEventStatsType();
+    if (columnar_)
+      eventStatsColumns_ = new HDF5ColumnTable(group_, event_stats_table_name, memtypeEventStats_);
+    else {
+      eventStatsTable_ = createTable(group_, event_stats_table_name, memtypeEventStats_);
+      eventStatsIndex_ = new HDF5EventIndex(indexGroup_, event_stats_table_name);
+    }
+  }
+
+  event_stats_t stats;
+  stats.event_id         = evt_number;
+  stats.output_id        = output_id;
+  stats.stored           = output_id >= 0;
+  stats.steps            = steps;
+  stats.el_photons       = el_photons;
+  stats.scint_photons    = scint_photons;
+  stats.ie               = ie;
+  stats.detected_photons = detected_photons;
+  stats.wall_time        = wall_time;
+  stats.cpu_time         = cpu_time;
+  if (columnar_) eventStatsColumns_->Append(&stats);
+  else {
+    writeEventStats(&stats, eventStatsTable_, memtypeEventStats_, istats_);
+    eventStatsIndex_->Add(evt_number, istats_);
+  }
+
+  istats_++;
+}
+
+void HDF5Writer::WriteEventWeight(int evt_number, double weight)
+{
+  // The table is optional, so it is only created when first needed
+  if (!eventWeightTable_ && !eventWeightColumns_) {
+    std::string event_weight_table_name = "event_weights";
+    memtypeEventWeight_ = createEventWeightType();
+    if (columnar_)
+      eventWeightColumns_ = new HDF5ColumnTable(group_, event_weight_table_name, memtypeEventWeight_);
+    else {
+      eventWeightTable_ = createTable(group_, event_weight_table_name, memtypeEventWeight_);
+      eventWeightIndex_ = new HDF5EventIndex(indexGroup_, event_weight_table_name);
+    }
+  }
+
+  event_weight_t w;
+  w.event_id = evt_number;
+  w.weight   = weight;
+  if (columnar_) eventWeightColumns_->Append(&w);
+  else {
+    writeEventWeight(&w, eventWeightTable_, memtypeEventWeight_, iweight_);
+    eventWeightIndex_->Add(evt_number, iweight_);
+  }
+
+  iweight_++;
+}
+
+void HDF5Writer::WriteParticleWeight(int evt_number, int particle_indx, double weight)
+{
+  // The table is optional, so it is only created when first needed
+  if (!particleWeightTable_ && !particleWeightColumns_) {
+    std::string particle_weight_table_name = "particle_weights";
+    memtypeParticleWeight_ = createParticleWeightType();
+    if (columnar_)
+      particleWeightColumns_ = new HDF5ColumnTable(group_, particle_weight_table_name, memtypeParticleWeight_);
+    else {
+      particleWeightTable_ = createTable(group_, particle_weight_table_name, memtypeParticleWeight_);
+      particleWeightIndex_ = new HDF5EventIndex(indexGroup_, particle_weight_table_name);
+    }
+  }
+
+  particle_weight_t w;
+  w.event_id    = evt_number;
+  w.particle_id = particle_indx;
+  w.weight      = weight;
+  if (columnar_) particleWeightColumns_->Append(&w);
+  else {
+    writeParticleWeight(&w, particleWeightTable_, memtypeParticleWeight_, ipartweight_);
+    particleWeightIndex_->Add(evt_number, ipartweight_);
+  }
+
+  ipartweight_++;
+}
+
+void HDF5Writer::WriteHitWeight(int evt_number, int particle_indx, int hit_indx, const char* label, double weight)
+{
+  // The table is optional, so it is only created when first needed
+  if (!hitWeightTable_ && !hitWeightColumns_) {
+    std::string hit_weight_table_name = "hit_weights";
+    memtypeHitWeight_ = createHitWeightType();
+    if (columnar_)
+      hitWeightColumns_ = new HDF5ColumnTable(group_, hit_weight_table_name, memtypeHitWeight_);
+    else {
+      hitWeightTable_ = createTable(group_, hit_weight_table_name, memtypeHitWeight_);
+      hitWeightIndex_ = new HDF5EventIndex(indexGroup_, hit_weight_table_name);
+    }
+  }
+
+  hit_weight_t w;
+  w.event_id    = evt_number;
+  memset(w.label, 0, STRLEN);
+  strcpy(w.label, label);
+  w.particle_id = particle_indx;
+  w.hit_id      = hit_indx;
+  w.weight      = weight;
+  if (columnar_) hitWeightColumns_->Append(&w);
+  else {
+    writeHitWeight(&w, hitWeightTable_, memtypeHitWeight_, ihitweight_);
+    hitWeightIndex_->Add(evt_number, ihitweight_);
+  }
+
+  ihitweight_++;
+}
@@ -10,9 +10,12 @@
 #define HDF5WRITER_H
 
 #include "hdf5_functions.h"
+#include "HDF5ColumnTable.h"
+#include "HDF5EventIndex.h"
 
 #include <hdf5.h>
 #include <iostream>
+#include <vector>
 
 namespace nexus {
 
@@ -24,14 +27,18 @@ namespace nexus {
     /// destructor
     ~HDF5Writer();
 
-    /// open file
-    void Open(std::string filename, bool debug);
+    /// open file. In columnar layout, each table of per-event data is
+    /// a group with a dataset per column and an index of the events.
+    /// Otherwise, the indexes of the tables are in an event_index group.
+    void Open(std::string filename, bool debug, bool columnar=false);
 
     /// close file
     void Close();
 
     void WriteRunInfo(const char* param_key, const char* param_value);
     void WriteSensorDataInfo(int evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge);
+    /// Write the waveform of a sensor in the sparse format (see SparseWaveform.h)
+    void WriteSensorWaveform(int evt_number, unsigned int sensor_id, unsigned int start_bin, const std::vector<uint16_t>& values);
     void WriteHitInfo(int evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label);
     void WriteParticleInfo(int evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc);
     void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z);
@@ -43,12 +50,21 @@ namespace nexus {
                    const char*      proc_name,
                    float initial_x, float initial_y, float initial_z,
                    float   final_x, float   final_y, float   final_z);
+    void WriteEventStats(int evt_number, int output_id, uint64_t steps,
+                         uint64_t el_photons, uint64_t scint_photons,
+                         uint64_t ie, uint64_t detected_photons,
+                         float wall_time, float cpu_time);
+    void WriteEventWeight(int evt_number, double weight);
+    void WriteParticleWeight(int evt_number, int particle_indx, double weight);
+    void WriteHitWeight(int evt_number, int particle_indx, int hit_indx, const char* label, double weight);
 
   private:
     size_t file_; ///< HDF5 file
+    size_t group_; ///< MC group
 
     bool isOpen_;
     bool firstEvent_; ///< First event
+    bool columnar_; ///< Columnar layout of the per-event tables
 
     //Datasets
     size_t runTable_;
@@ -57,6 +73,36 @@ namespace nexus {
     size_t particleInfoTable_;
     size_t snsPosTable_;
     size_t stepTable_;
+    size_t eventStatsTable_;
+    size_t eventWeightTable_;
+    size_t particleWeightTable_;
+    size_t hitWeightTable_;
+    size_t snsWaveformTable_;
+    size_t snsWaveformValues_; ///< Values of the sparse waveforms
+
+    size_t indexGroup_; ///< Group of the event indexes (row layout)
+
+    // Event indexes of the per-event tables in row layout
+    HDF5EventIndex* snsDataIndex_;
+    HDF5EventIndex* hitInfoIndex_;
+    HDF5EventIndex* particleInfoIndex_;
+    HDF5EventIndex* stepIndex_;
+    HDF5EventIndex* eventStatsIndex_;
+    HDF5EventIndex* eventWeightIndex_;
+    HDF5EventIndex* particleWeightIndex_;
+    HDF5EventIndex* hitWeightIndex_;
+    HDF5EventIndex* snsWaveformIndex_;
+
+    // Per-event tables in columnar layout
+    HDF5ColumnTable* snsDataColumns_;
+    HDF5ColumnTable* hitInfoColumns_;
+    HDF5ColumnTable* particleInfoColumns_;
+    HDF5ColumnTable* stepColumns_;
+    HDF5ColumnTable* eventStatsColumns_;
+    HDF5ColumnTable* eventWeightColumns_;
+    HDF5ColumnTable* particleWeightColumns_;
+    HDF5ColumnTable* hitWeightColumns_;
+    HDF5ColumnTable* snsWaveformColumns_;
 
     size_t memtypeRun_;
     size_t memtypeSnsData_;
@@ -64,6 +110,11 @@ namespace nexus {
     size_t memtypeParticleInfo_;
     size_t memtypeSnsPos_;
     size_t memtypeStep_;
+    size_t memtypeEventStats_;
+    size_t memtypeEventWeight_;
+    size_t memtypeParticleWeight_;
+    size_t memtypeHitWeight_;
+    size_t memtypeSnsWaveform_;
 
     size_t irun_; ///< counter for configuration parameters
     size_t ismp_; ///< counter for written waveform samples
@@ -71,6 +122,12 @@ namespace nexus {
     size_t ipart_; ///< counter for particle information
     size_t ipos_; ///< counter for sensor positions
     size_t istep_; ///< counter for steps
+    size_t istats_; ///< counter for event statistics
+    size_t iweight_; ///< counter for event weights
+    size_t ipartweight_; ///< counter for particle weights
+    size_t ihitweight_; ///< counter for hit weights
+    size_t iwvf_; ///< counter for sparse waveforms
+    size_t iwvfval_; ///< counter for values of sparse waveforms
 
   };
 
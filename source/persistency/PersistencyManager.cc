@@ -16,22 +16,30 @@
 #include "NexusApp.h"
 #include "DetectorConstruction.h"
 #include "SaveAllSteppingAction.h"
+#include "DefaultTrackingAction.h"
 #include "GeometryBase.h"
 #include "HDF5Writer.h"
 #include "PersistencyManagerBase.h"
 #include "FactoryBase.h"
+#include "StartupTimer.h"
+#include "EventStats.h"
+#include "SparseWaveform.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Event.hh>
+#include <G4PrimaryVertex.hh>
 #include <G4TrajectoryContainer.hh>
 #include <G4Trajectory.hh>
 #include <G4SDManager.hh>
 #include <G4HCtable.hh>
 #include <G4RunManager.hh>
 #include <G4Run.hh>
+#include <G4UIcommand.hh>
+#include <Randomize.hh>
 
 #include <string>
 #include <sstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
 
@@ -44,9 +52,14 @@ REGISTER_CLASS(PersistencyManager, PersistencyManagerBase)
 PersistencyManager::PersistencyManager():
   PersistencyManagerBase(), msg_(0), ready_(false),
   store_evt_(true), store_steps_(false),
-  interacting_evt_(false), save_ie_numb_(false), event_type_("other"),
+  interacting_evt_(false), save_ie_numb_(false), event_stats_(false),
+  sparse_wvf_(false),
+  event_type_("other"), layout_("row"),
   saved_evts_(0), interacting_evts_(0), pmt_bin_size_(-1), sipm_bin_size_(-1),
-  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0)
+  nevt_(0), start_id_(0), run_offset_(0), first_evt_(true), id_from_event_(false),
+  event_weight_(1.),
+  shard_index_(-1), shard_count_(0), shard_first_(0), shard_events_(0),
+  h5writer_(0)
 {
   msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
   msg_->DeclareMethod("outputFile", &PersistencyManager::OpenFile, "");
@@ -54,6 +67,24 @@ PersistencyManager::PersistencyManager():
                         "Type of event: bb0nu, bb2nu, background.");
   msg_->DeclareProperty("start_id", start_id_,
                         "Starting event ID for this job.");
+  msg_->DeclareProperty("event_stats", event_stats_,
+                        "Save per-event performance counters in the output file "
+                        "(requires DefaultTrackingAction).");
+  msg_->DeclareProperty("sparse_waveforms", sparse_wvf_,
+                        "Save the sensor waveforms as encoded runs of non-empty "
+                        "bins (sns_waveforms) instead of one row per bin (sns_response).");
+  G4GenericMessenger::Command& layout_cmd =
+    msg_->DeclareMethod("layout", &PersistencyManager::SetLayout,
+                        "Layout of the per-event tables: row (one compound dataset "
+                        "per table) or column (one dataset per column). It must "
+                        "be set before the output file.");
+  layout_cmd.SetCandidates("row column");
+  msg_->DeclareMethod("hit_voxel_size", &PersistencyManager::SetHitVoxelSize,
+                      "Size (x y z unit) of the voxels in which ionization hits "
+                      "are accumulated. Zero disables the voxelization.");
+  msg_->DeclareMethod("hit_voxel_per_track", &PersistencyManager::SetHitVoxelPerTrack,
+                      "Accumulate the ionization hits in voxels per track "
+                      "(true) or per event (false).");
 
   init_macro_ = "";
   macros_.clear();
@@ -95,8 +126,18 @@ void PersistencyManager::OpenFile(G4String filename)
   // If the output file was not set yet, do so
   if (!h5writer_) {
     h5writer_ = new HDF5Writer();
+
+    // The files of the shards of a production are numbered
+    // with as many digits as needed for the number of shards
+    if (shard_count_ > 0) {
+      std::ostringstream suffix;
+      suffix << "_shard" << std::setw(std::to_string(shard_count_ - 1).size())
+             << std::setfill('0') << shard_index_ << "of" << shard_count_;
+      filename += suffix.str();
+    }
+
     G4String hdf5file = filename + ".h5";
-    h5writer_->Open(hdf5file, store_steps_);
+    h5writer_->Open(hdf5file, store_steps_, layout_ == "column");
     return;
   } else {
     G4Exception("[PersistencyManager]", "OpenFile()",
@@ -106,6 +147,59 @@ void PersistencyManager::OpenFile(G4String filename)
 
 
 
+void PersistencyManager::SetLayout(G4String layout)
+{
+  if (h5writer_)
+    G4Exception("[PersistencyManager]", "SetLayout()", FatalException,
+                "The layout must be set before the output file is opened.");
+
+  layout_ = layout;
+}
+
+
+
+void PersistencyManager::SetShard(G4int index, G4int count)
+{
+  if (h5writer_)
+    G4Exception("[PersistencyManager]", "SetShard()", FatalException,
+                "The shard must be set before the output file is opened.");
+
+  shard_index_ = index;
+  shard_count_ = count;
+}
+
+
+
+void PersistencyManager::SetShardRange(G4int first, G4int n)
+{
+  shard_first_  = first;
+  shard_events_ = n;
+}
+
+
+
+void PersistencyManager::SetHitVoxelSize(G4String params)
+{
+  std::istringstream iss(params);
+  G4double x, y, z;
+  G4String unit;
+  if (!(iss >> x >> y >> z >> unit) || x < 0. || y < 0. || z < 0.)
+    G4Exception("[PersistencyManager]", "SetHitVoxelSize()", FatalException,
+                "Expected: x y z unit, with non-negative sizes.");
+
+  G4double u = G4UIcommand::ValueOf(unit);
+  IonizationSD::SetVoxelSize(G4ThreeVector(x*u, y*u, z*u));
+}
+
+
+
+void PersistencyManager::SetHitVoxelPerTrack(G4bool per_track)
+{
+  IonizationSD::SetVoxelPerTrack(per_track);
+}
+
+
+
 void PersistencyManager::CloseFile()
 {
   if (!h5writer_) return;
@@ -117,11 +211,20 @@ void PersistencyManager::CloseFile()
 
 G4bool PersistencyManager::Store(const G4Event* event)
 {
+  // Steps and scintillation photons are counted by DefaultTrackingAction
+  if (event_stats_ && !dynamic_cast<const DefaultTrackingAction*>
+      (G4RunManager::GetRunManager()->GetUserTrackingAction()))
+    G4Exception("[PersistencyManager]", "Store()", FatalException,
+                "The event_stats option requires DefaultTrackingAction.");
+
   if (interacting_evt_) {
     interacting_evts_++;
   }
 
   if (!store_evt_) {
+    // The performance counters of all events are numbered as the
+    // generated events, which only have an output ID if stored
+    if (event_stats_) StoreEventStats(GetStartID() + event->GetEventID(), -1);
     TrajectoryMap::Clear();
     if (store_steps_) {
       SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
@@ -135,18 +238,29 @@ G4bool PersistencyManager::Store(const G4Event* event)
 
   if (first_evt_) {
     first_evt_ = false;
-    nevt_ = start_id_;
+    nevt_ = start_id_ + shard_first_;
   }
 
+  // Events with their own random stream keep its number, so that
+  // they can be generated again from their ID even if others were
+  // discarded before them
+  if (id_from_event_) nevt_ = GetStartID() + event->GetEventID();
+
   if (store_steps_)
     StoreSteps();
 
+  // The event weight is needed before the trajectories and hits,
+  // whose weights are stored relative to it
+  StoreEventWeight(event);
+
   // Store the trajectories of the event
   StoreTrajectories(event->GetTrajectoryContainer());
 
   // Store ionization hits and sensor hits
   StoreHits(event->GetHCofThisEvent());
 
+  if (event_stats_) StoreEventStats(GetStartID() + event->GetEventID(), nevt_);
+
   nevt_++;
 
   TrajectoryMap::Clear();
@@ -206,6 +320,12 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
                                  trj->GetCreatorProcess().c_str(),
 				 trj->GetFinalProcess().c_str());
 
+    // Track weights include the event weight: only the part added by
+    // the biasing (the ratio) is written, when different from one
+    G4double weight = RelativeWeight(trj->GetInitialWeight());
+    if (weight != 1.)
+      h5writer_->WriteParticleWeight(nevt_, trackid, weight);
+
   }
 }
 
@@ -264,23 +384,19 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
 
     G4int trackid = hit->GetTrackID();
 
-    std::vector<G4int>* ihits = nullptr;
-    std::map<G4int, std::vector<G4int>* >::iterator it = hit_map_.find(trackid);
-    if (it != hit_map_.end()) {
-      ihits = it->second;
-    } else {
-       ihits = new std::vector<G4int>;
-      hit_map_[trackid] = ihits;
-    }
-
-    ihits->push_back(1);
+    // Hits are numbered per track
+    G4int hitid = hit_map_[trackid]++;
 
     G4ThreeVector xyz = hit->GetPosition();
-    h5writer_->WriteHitInfo(nevt_, trackid,  ihits->size() - 1,
+    h5writer_->WriteHitInfo(nevt_, trackid, hitid,
 			    xyz[0], xyz[1], xyz[2],
 			    hit->GetTime(), hit->GetEnergyDeposit(),
 			    sdname.c_str());
 
+    G4double weight = RelativeWeight(hit->GetWeight());
+    if (weight != 1.)
+      h5writer_->WriteHitWeight(nevt_, trackid, hitid, sdname.c_str(), weight);
+
     evt_energy += hit->GetEnergyDeposit();
   }
 }
@@ -315,7 +431,7 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
 
     const std::map<G4double, G4int>& wvfm = hit->GetHistogram();
     std::map<G4double, G4int>::const_iterator it;
-    std::vector< std::pair<unsigned int,float> > data;
+    std::vector< std::pair<unsigned int,unsigned int> > data;
     G4double amplitude = 0.;
 
     for (it = wvfm.begin(); it != wvfm.end(); ++it) {
@@ -325,8 +441,16 @@ void PersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
       data.push_back(std::make_pair(time_bin, charge));
       amplitude = amplitude + (*it).second;
 
-      h5writer_->WriteSensorDataInfo(nevt_, (unsigned int)hit->GetPmtID(),
-                                     time_bin, charge);
+      if (!sparse_wvf_)
+        h5writer_->WriteSensorDataInfo(nevt_, (unsigned int)hit->GetPmtID(),
+                                       time_bin, charge);
+    }
+
+    if (sparse_wvf_ && !data.empty()) {
+      wvf_values_.clear();
+      EncodeWaveform(data, wvf_values_);
+      h5writer_->WriteSensorWaveform(nevt_, (unsigned int)hit->GetPmtID(),
+                                     data.front().first, wvf_values_);
     }
 
     std::vector<G4int>::iterator pos_it =
@@ -374,6 +498,42 @@ void PersistencyManager::StoreSteps()
   sa->Reset();
 }
 
+void PersistencyManager::StoreEventStats(G4int event_id, G4int output_id)
+{
+  h5writer_->WriteEventStats(event_id, output_id,
+                             EventStats::GetSteps(),
+                             EventStats::GetELPhotons(),
+                             EventStats::GetScintillationPhotons(),
+                             EventStats::GetIonizationElectrons(),
+                             EventStats::GetDetectedPhotons(),
+                             EventStats::GetWallTime()/second,
+                             EventStats::GetCPUTime()/second);
+}
+
+
+
+void PersistencyManager::StoreEventWeight(const G4Event* event)
+{
+  // Event weight is the product of the weights of the primary vertices.
+  // Only events with a weight different from one are written.
+  event_weight_ = 1.;
+  for (G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i)
+    event_weight_ *= event->GetPrimaryVertex(i)->GetWeight();
+
+  if (event_weight_ != 1.)
+    h5writer_->WriteEventWeight(nevt_, event_weight_);
+}
+
+
+
+G4double PersistencyManager::RelativeWeight(G4double weight) const
+{
+  // Geant4 starts the weight of the primary tracks at the weight of their
+  // vertex, so the weight of every track and hit includes the event weight
+  if (event_weight_ == 0.) return weight;
+  return weight / event_weight_;
+}
+
 G4bool PersistencyManager::Store(const G4Run*)
 {
   // Store the event type
@@ -400,6 +560,23 @@ G4bool PersistencyManager::Store(const G4Run*)
                            (std::to_string(it->second/microsecond)+" mus").c_str());
   }
 
+  // Store the position of the job in a sharded production
+  if (shard_count_ > 0) {
+    h5writer_->WriteRunInfo("shard_index", std::to_string(shard_index_).c_str());
+    h5writer_->WriteRunInfo("shard_count", std::to_string(shard_count_).c_str());
+    h5writer_->WriteRunInfo("shard_first_event",
+                            std::to_string(start_id_ + shard_first_).c_str());
+    h5writer_->WriteRunInfo("shard_num_events", std::to_string(shard_events_).c_str());
+    h5writer_->WriteRunInfo("random_seed",
+                            std::to_string(CLHEP::HepRandom::getTheSeed()).c_str());
+  }
+
+  // Store the time spent in each phase of the initialization
+  for (const auto& phase: StartupTimer::GetPhases()) {
+    h5writer_->WriteRunInfo(("init_time/" + phase.first).c_str(),
+                            (std::to_string(phase.second/second)+" s").c_str());
+  }
+
   SaveConfigurationInfo(init_macro_);
   for (unsigned long i=0; i<macros_.size(); i++) {
     SaveConfigurationInfo(macros_[i]);
@@ -13,6 +13,7 @@
 #include "PersistencyManagerBase.h"
 
 #include <G4VPersistencyManager.hh>
+#include <cstdint>
 #include <map>
 #include <vector>
 
@@ -59,6 +60,17 @@ namespace nexus {
     void OpenFile(G4String);
     void CloseFile();
 
+    G4int GetStartID() const;
+
+    void SetShard(G4int index, G4int count);
+    void SetShardRange(G4int first, G4int n);
+    void SetRunOffset(G4int n);
+    void SetIDFromEventNumber(G4bool);
+
+    void SetLayout(G4String);
+    void SetHitVoxelSize(G4String);
+    void SetHitVoxelPerTrack(G4bool);
+
 
   private:
     void StoreTrajectories(G4TrajectoryContainer*);
@@ -66,6 +78,10 @@ namespace nexus {
     void StoreIonizationHits(G4VHitsCollection*);
     void StoreSensorHits(G4VHitsCollection*);
     void StoreSteps();
+    void StoreEventStats(G4int event_id, G4int output_id);
+    void StoreEventWeight(const G4Event*);
+    /// Weight of a track or hit divided by the weight of the event
+    G4double RelativeWeight(G4double weight) const;
 
     void SaveConfigurationInfo(G4String history);
 
@@ -83,8 +99,11 @@ namespace nexus {
     G4bool store_steps_; ///< Should we store the steps for the current event?
     G4bool interacting_evt_; ///< Has the current event interacted in ACTIVE?
     G4bool save_ie_numb_; ///< Should we save the number of interacting events in the configuration table?
+    G4bool event_stats_; ///< Should we save the per-event performance counters?
+    G4bool sparse_wvf_; ///< Should we save the sensor waveforms in the sparse format?
 
     G4String event_type_; ///< event type: bb0nu, bb2nu, background or not set
+    G4String layout_; ///< Layout of the per-event tables: row or column
 
     G4int saved_evts_; ///< number of events to be saved
     G4int interacting_evts_; ///< number of events interacting in ACTIVE
@@ -92,11 +111,20 @@ namespace nexus {
 
     G4int nevt_; ///< Event ID
     G4int start_id_; ///< ID for the first event in file
+    G4int run_offset_; ///< Events of the previous runs of the job
     G4bool first_evt_; ///< true only for the first event of the run
+    G4bool id_from_event_; ///< Is the event ID the number of the generated event?
+    G4double event_weight_; ///< Weight of the current event
+
+    G4int shard_index_;  ///< Shard of the production (or -1)
+    G4int shard_count_;  ///< Number of shards of the production
+    G4int shard_first_;  ///< First event of the production run by the shard
+    G4int shard_events_; ///< Number of events run by the shard
 
     HDF5Writer* h5writer_;  ///< Event writer to hdf5 file
 
-    std::map<G4int, std::vector<G4int>* > hit_map_;
+    std::map<G4int, G4int> hit_map_; ///< Number of hits per track
+    std::vector<uint16_t> wvf_values_; ///< Encoded waveform of a sensor
     std::vector<G4int> sns_posvec_;
 
     std::map<G4String, G4double> sensdet_bin_;
@@ -113,6 +141,12 @@ namespace nexus {
   { interacting_evt_ = ie; }
   inline void PersistencyManager::SaveNumbOfInteractingEvents(G4bool sie)
   {save_ie_numb_ = sie;}
+  inline G4int PersistencyManager::GetStartID() const
+  { return start_id_ + run_offset_ + shard_first_; }
+  inline void PersistencyManager::SetRunOffset(G4int n)
+  { run_offset_ = n; }
+  inline void PersistencyManager::SetIDFromEventNumber(G4bool id)
+  { id_from_event_ = id; }
   inline G4bool PersistencyManager::Store(const G4VPhysicalVolume*)
   { return false; }
   inline G4bool PersistencyManager::Retrieve(G4Event*&)
@@ -13,6 +13,22 @@ class PersistencyManagerBase: public G4VPersistencyManager
 
      virtual void CloseFile() = 0;
 
+     /// ID of the first event of the current run
+     virtual G4int GetStartID() const { return 0; }
+
+     /// Number of events of the previous runs of the job (of the whole
+     /// production, when sharded), which the IDs of the run follow
+     virtual void SetRunOffset(G4int) {}
+
+     /// Make the output that of shard i of N of a production
+     virtual void SetShard(G4int /*index*/, G4int /*count*/) {}
+     /// Set the range of events of the production run by the shard
+     virtual void SetShardRange(G4int /*first*/, G4int /*n*/) {}
+     /// Number the stored events as the generated ones (start ID plus
+     /// event number), instead of consecutively, when each event has
+     /// its own random stream
+     virtual void SetIDFromEventNumber(G4bool) {}
+
      G4String init_macro_;
      std::vector<G4String> macros_;
      std::vector<G4String> delayed_macros_;
@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------------
+// nexus | SparseWaveform.cc
+//
+// Encoding of the sensor waveforms in the sparse output format.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SparseWaveform.h"
+
+#include <G4Exception.hh>
+
+
+namespace {
+
+  const uint16_t LONG_FLAG = 0x8000;
+
+  void Push(uint32_t v, std::vector<uint16_t>& values)
+  {
+    if (v < LONG_FLAG) {
+      values.push_back(uint16_t(v));
+    }
+    else {
+      if (v >> 31)
+        G4Exception("[SparseWaveform]", "EncodeWaveform()", FatalException,
+                    "Value too large for the sparse waveform encoding.");
+      values.push_back(uint16_t(LONG_FLAG | (v >> 16)));
+      values.push_back(uint16_t(v & 0xFFFF));
+    }
+  }
+
+  uint32_t Pop(const uint16_t* values, size_t n, size_t& i)
+  {
+    if (i >= n)
+      G4Exception("[SparseWaveform]", "DecodeWaveform()", FatalException,
+                  "Truncated sparse waveform.");
+    uint32_t v = values[i++];
+    if (v & LONG_FLAG) {
+      if (i >= n)
+        G4Exception("[SparseWaveform]", "DecodeWaveform()", FatalException,
+                    "Truncated sparse waveform.");
+      v = ((v & ~uint32_t(LONG_FLAG)) << 16) | values[i++];
+    }
+    return v;
+  }
+
+} // namespace
+
+
+namespace nexus {
+
+  void EncodeWaveform(const std::vector<std::pair<unsigned int, unsigned int>>& bins,
+                      std::vector<uint16_t>& values)
+  {
+    size_t i = 0;
+    unsigned int next_bin = bins.empty() ? 0 : bins.front().first;
+
+    while (i < bins.size()) {
+      // Run of consecutive bins from i to j
+      size_t j = i + 1;
+      while (j < bins.size() && bins[j].first == bins[j-1].first + 1) ++j;
+
+      Push(bins[i].first - next_bin, values);
+      Push(uint32_t(j - i), values);
+      for (size_t k=i; k<j; ++k) Push(bins[k].second, values);
+
+      next_bin = bins[j-1].first + 1;
+      i = j;
+    }
+  }
+
+
+  std::vector<std::pair<unsigned int, unsigned int>>
+  DecodeWaveform(unsigned int start_bin, const uint16_t* values, size_t n)
+  {
+    std::vector<std::pair<unsigned int, unsigned int>> bins;
+
+    size_t i = 0;
+    unsigned int bin = start_bin;
+
+    while (i < n) {
+      bin += Pop(values, n, i);
+      uint32_t length = Pop(values, n, i);
+      for (uint32_t k=0; k<length; ++k)
+        bins.push_back(std::make_pair(bin++, Pop(values, n, i)));
+    }
+
+    return bins;
+  }
+
+} // namespace nexus
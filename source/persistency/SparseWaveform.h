@@ -0,0 +1,34 @@
+// ----------------------------------------------------------------------------
+// nexus | SparseWaveform.h
+//
+// Encoding of the sensor waveforms in the sparse output format. Only the
+// non-empty bins are kept, as runs of consecutive bins: for each run, the
+// number of empty bins before it, its length and the charges of its bins.
+// Numbers below 2^15 take one 16-bit word; larger ones (below 2^31) take
+// two words, the first with the highest bit set.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SPARSE_WAVEFORM_H
+#define SPARSE_WAVEFORM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nexus {
+
+  /// Append to values the encoding of a waveform, given as (time bin, charge)
+  /// pairs sorted by time bin. The first bin of the waveform is not encoded.
+  void EncodeWaveform(const std::vector<std::pair<unsigned int, unsigned int>>& bins,
+                      std::vector<uint16_t>& values);
+
+  /// Decode n values of a waveform whose first bin is start_bin
+  std::vector<std::pair<unsigned int, unsigned int>>
+  DecodeWaveform(unsigned int start_bin, const uint16_t* values, size_t n);
+
+} // namespace nexus
+
+#endif
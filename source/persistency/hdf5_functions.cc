@@ -134,6 +134,79 @@ hsize_t createStepType()
   return memtype;
 }
 
+hsize_t createEventStatsType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_stats_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_stats_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "output_id", HOFFSET (event_stats_t, output_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "stored", HOFFSET (event_stats_t, stored), H5T_NATIVE_CHAR);
+  H5Tinsert (memtype, "steps", HOFFSET (event_stats_t, steps), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "el_photons", HOFFSET (event_stats_t, el_photons), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "scint_photons", HOFFSET (event_stats_t, scint_photons), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "ie", HOFFSET (event_stats_t, ie), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "detected_photons", HOFFSET (event_stats_t, detected_photons), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "wall_time", HOFFSET (event_stats_t, wall_time), H5T_NATIVE_FLOAT);
+  H5Tinsert (memtype, "cpu_time", HOFFSET (event_stats_t, cpu_time), H5T_NATIVE_FLOAT);
+  return memtype;
+}
+
+hsize_t createEventWeightType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_weight_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_weight_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "weight", HOFFSET (event_weight_t, weight), H5T_NATIVE_DOUBLE);
+  return memtype;
+}
+
+hsize_t createParticleWeightType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (particle_weight_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (particle_weight_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "particle_id", HOFFSET (particle_weight_t, particle_id), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "weight", HOFFSET (particle_weight_t, weight), H5T_NATIVE_DOUBLE);
+  return memtype;
+}
+
+hsize_t createHitWeightType()
+{
+  //Create compound datatype for the table
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size (strtype, STRLEN);
+
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (hit_weight_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (hit_weight_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "label", HOFFSET (hit_weight_t, label), strtype);
+  H5Tinsert (memtype, "particle_id", HOFFSET (hit_weight_t, particle_id), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "hit_id", HOFFSET (hit_weight_t, hit_id), H5T_NATIVE_INT);
+  H5Tinsert (memtype, "weight", HOFFSET (hit_weight_t, weight), H5T_NATIVE_DOUBLE);
+  return memtype;
+}
+
+hsize_t createEventIndexType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (event_index_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (event_index_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "first_row", HOFFSET (event_index_t, first_row), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "n_rows", HOFFSET (event_index_t, n_rows), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
+hsize_t createSensorWaveformType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof (sns_waveform_t));
+  H5Tinsert (memtype, "event_id", HOFFSET (sns_waveform_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert (memtype, "sensor_id", HOFFSET (sns_waveform_t, sensor_id), H5T_NATIVE_UINT32);
+  H5Tinsert (memtype, "start_bin", HOFFSET (sns_waveform_t, start_bin), H5T_NATIVE_UINT32);
+  H5Tinsert (memtype, "n_values", HOFFSET (sns_waveform_t, n_values), H5T_NATIVE_UINT32);
+  H5Tinsert (memtype, "first_value", HOFFSET (sns_waveform_t, first_value), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
 hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
 {
   //Create 1D dataspace (evt number). First dimension is unlimited (initially 0)
@@ -292,3 +365,126 @@ void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter)
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
+
+void writeEventStats(event_stats_t* stats, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, stats);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeEventWeight(event_weight_t* weight, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, weight);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeParticleWeight(particle_weight_t* weight, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, weight);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeHitWeight(hit_weight_t* weight, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, weight);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeSnsWaveform(sns_waveform_t* wvf, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + 1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, wvf);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+void writeSnsWaveformValues(const uint16_t* values, hsize_t n, hid_t dataset, hsize_t counter)
+{
+  if (n == 0) return;
+
+  hid_t memspace, file_space;
+
+  //Create memspace for all the values of the waveform
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {n};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter + n;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {n};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, H5T_NATIVE_UINT16, memspace, file_space, H5P_DEFAULT, values);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
@@ -91,12 +91,66 @@
     float     final_z;
   } step_info_t;
 
+  typedef struct{
+    int32_t event_id;  ///< Number of the generated event
+    int32_t output_id; ///< ID of the event in the other tables (-1 if discarded)
+    char stored;       ///< 0 for discarded events
+    uint64_t steps;
+    uint64_t el_photons;
+    uint64_t scint_photons;
+    uint64_t ie;
+    uint64_t detected_photons;
+    float wall_time;
+    float cpu_time;
+  } event_stats_t;
+
+  typedef struct{
+    int32_t event_id;
+    double weight;
+  } event_weight_t;
+
+  // The particle and hit weights are relative to the event weight:
+  // the total weight is the product of both
+  typedef struct{
+    int32_t event_id;
+    int particle_id;
+    double weight;
+  } particle_weight_t;
+
+  typedef struct{
+    int32_t event_id;
+    char label[STRLEN];
+    int particle_id;
+    int hit_id;
+    double weight;
+  } hit_weight_t;
+
+  typedef struct{
+    int32_t event_id;
+    uint64_t first_row;
+    uint64_t n_rows;
+  } event_index_t;
+
+  typedef struct{
+    int32_t event_id;
+    uint32_t sensor_id;
+    uint32_t start_bin;
+    uint32_t n_values;
+    uint64_t first_value;
+  } sns_waveform_t;
+
   hsize_t createRunType();
   hsize_t createSensorDataType();
   hsize_t createHitInfoType();
   hsize_t createParticleInfoType();
   hsize_t createSensorPosType();
   hsize_t createStepType();
+  hsize_t createEventStatsType();
+  hsize_t createEventWeightType();
+  hsize_t createParticleWeightType();
+  hsize_t createHitWeightType();
+  hsize_t createEventIndexType();
+  hsize_t createSensorWaveformType();
 
   hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype);
   hid_t createGroup(hid_t file, std::string& groupName);
@@ -107,6 +161,12 @@
   void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeEventStats(event_stats_t* stats, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeEventWeight(event_weight_t* weight, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeParticleWeight(particle_weight_t* weight, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeHitWeight(hit_weight_t* weight, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSnsWaveform(sns_waveform_t* wvf, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeSnsWaveformValues(const uint16_t* values, hsize_t n, hid_t dataset, hsize_t counter);
 
 
 #endif
@@ -40,6 +40,11 @@ namespace nexus {
 
     virtual G4double LightYield() const;
 
+    /// Returns true if all drift lines end in the same volume
+    /// (e.g. the EL gap), so that the drift process can reuse the
+    /// touchable of the end point instead of relocating every electron
+    virtual G4bool HasFixedDestination() const;
+
   private:
     void Print() const;
   };
@@ -52,6 +57,8 @@ namespace nexus {
 
   inline G4double BaseDriftField::LightYield() const {return 0.;}
 
+  inline G4bool BaseDriftField::HasFixedDestination() const {return false;}
+
   inline void BaseDriftField::Print() const {}
 
 } // end namespace nexus
@@ -0,0 +1,151 @@
+// ----------------------------------------------------------------------------
+// nexus | ELSensorKernel.cc
+//
+// Precomputed light-transport kernel of an EL gap: for each point of a
+// grid in the gate plane, the probability that an EL photon emitted by
+// an electron entering the gap at that point is detected by each sensor.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ELSensorKernel.h"
+
+#include <G4Exception.hh>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include "CLHEP/Units/SystemOfUnits.h"
+
+
+namespace {
+
+  struct KernelHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t n_sd;
+    uint32_t n_sensors;
+    uint32_t nx;
+    uint32_t ny;
+    double   min[2];
+    double   step[2];
+  };
+
+  struct KernelSensor {
+    int32_t  id;
+    uint32_t sd_index;
+    float    position[3];
+  };
+
+}
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+
+  ELSensorKernel::ELSensorKernel(const G4String& filename)
+  {
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (!in) {
+      G4String msg = "Cannot open EL sensor kernel " + filename;
+      G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, msg);
+    }
+
+    // Every length read from the file is checked against the bytes
+    // left in it before anything is allocated
+    const std::streamoff file_size = in.tellg();
+    in.seekg(0);
+    auto remaining = [&in, file_size]() -> uint64_t {
+      std::streamoff pos = in.tellg();
+      return (in && pos >= 0 && pos <= file_size) ? uint64_t(file_size - pos) : 0;
+    };
+    const G4String truncated = "EL sensor kernel " + filename + " is truncated.";
+
+    KernelHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, "NELK", 4) != 0 || header.version != 1 ||
+        header.nx == 0 || header.ny == 0 || header.step[0] <= 0. || header.step[1] <= 0.) {
+      G4String msg = filename + " is not a valid EL sensor kernel.";
+      G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, msg);
+    }
+
+    nx_ = header.nx;
+    ny_ = header.ny;
+    min_x_  = header.min[0] * mm;
+    min_y_  = header.min[1] * mm;
+    step_x_ = header.step[0] * mm;
+    step_y_ = header.step[1] * mm;
+
+    for (uint32_t i=0; i<header.n_sd; ++i) {
+      uint32_t length;
+      in.read(reinterpret_cast<char*>(&length), sizeof(length));
+      if (!in || length > remaining())
+        G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, truncated);
+      std::string name(length, '\0');
+      in.read(&name[0], length);
+      sd_names_.push_back(name);
+    }
+
+    if (uint64_t(header.n_sensors) * sizeof(KernelSensor) > remaining())
+      G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, truncated);
+    std::vector<KernelSensor> sensors(header.n_sensors);
+    in.read(reinterpret_cast<char*>(sensors.data()), sensors.size() * sizeof(KernelSensor));
+    for (const auto& s: sensors) {
+      if (s.sd_index >= sd_names_.size())
+        G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException,
+                    "Sensor with an unknown sensitive detector.");
+      Sensor sensor;
+      sensor.id = s.id;
+      sensor.sd_index = s.sd_index;
+      sensor.position = G4ThreeVector(s.position[0], s.position[1], s.position[2]) * mm;
+      sensors_.push_back(sensor);
+    }
+
+    if ((uint64_t(nx_) * ny_ + 1) * sizeof(uint32_t) > remaining())
+      G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, truncated);
+    offsets_.resize(nx_ * ny_ + 1);
+    in.read(reinterpret_cast<char*>(offsets_.data()), offsets_.size() * sizeof(uint32_t));
+
+    for (size_t i=0; i<nx_*ny_; ++i)
+      if (offsets_[i] > offsets_[i+1])
+        G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException,
+                    "Kernel offsets are not sorted.");
+    if (uint64_t(offsets_.back() - offsets_.front()) * sizeof(Entry) > remaining())
+      G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, truncated);
+
+    entries_.resize(offsets_.back() - offsets_.front());
+    in.read(reinterpret_cast<char*>(entries_.data()), entries_.size() * sizeof(Entry));
+    if (!in)
+      G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException, truncated);
+
+    for (const auto& e: entries_)
+      if (e.sensor >= sensors_.size())
+        G4Exception("[ELSensorKernel]", "ELSensorKernel()", FatalException,
+                    "Kernel entry with an unknown sensor.");
+  }
+
+
+
+  ELSensorKernel::~ELSensorKernel()
+  {
+  }
+
+
+
+  const ELSensorKernel::Entry* ELSensorKernel::Lookup(G4double x, G4double y, size_t& n) const
+  {
+    G4double u = std::floor((x - min_x_) / step_x_ + 0.5);
+    G4double v = std::floor((y - min_y_) / step_y_ + 0.5);
+    if (u < 0. || v < 0. || u >= nx_ || v >= ny_) {
+      n = 0;
+      return nullptr;
+    }
+
+    size_t node = size_t(v) * nx_ + size_t(u);
+    n = offsets_[node+1] - offsets_[node];
+    return entries_.data() + (offsets_[node] - offsets_.front());
+  }
+
+} // end namespace nexus
@@ -0,0 +1,88 @@
+// ----------------------------------------------------------------------------
+// nexus | ELSensorKernel.h
+//
+// Precomputed light-transport kernel of an EL gap: for each point of a
+// grid in the gate plane, the probability that an EL photon emitted by
+// an electron entering the gap at that point is detected by each sensor.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EL_SENSOR_KERNEL_H
+#define EL_SENSOR_KERNEL_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <vector>
+#include <stdint.h>
+
+
+namespace nexus {
+
+  /// The kernel is a binary file with the following layout (lengths
+  /// in mm, x running fastest in the grid):
+  ///
+  ///   header:  char magic[4] = "NELK", uint32 version = 1,
+  ///            uint32 n_sd, n_sensors, nx, ny,
+  ///            float64 min_x, min_y, step_x, step_y
+  ///   n_sd x:  uint32 length, char name[length]   (sensitive detectors)
+  ///   n_sensors x: int32 sensor_id, uint32 sd_index, float32 x, y, z
+  ///   nx*ny+1 x: uint32 offset of the first entry of each grid point
+  ///   entries: uint32 sensor_index, float32 detection_probability
+
+  class ELSensorKernel
+  {
+  public:
+    struct Sensor {
+      G4int id;
+      size_t sd_index;
+      G4ThreeVector position;
+    };
+
+    struct Entry {
+      uint32_t sensor;
+      float probability;
+    };
+
+  public:
+    /// Constructor reading the kernel from a file
+    ELSensorKernel(const G4String& filename);
+    /// Destructor
+    ~ELSensorKernel();
+
+    /// Return the entries of the grid point nearest to (x, y) and set n
+    /// to their number, or return nullptr outside the grid
+    const Entry* Lookup(G4double x, G4double y, size_t& n) const;
+
+    size_t GetNumberOfSensors() const;
+    const Sensor& GetSensor(size_t i) const;
+
+    size_t GetNumberOfSensitiveDetectors() const;
+    const G4String& GetSensitiveDetectorName(size_t i) const;
+
+  private:
+    size_t nx_, ny_;
+    G4double min_x_, min_y_;
+    G4double step_x_, step_y_;
+
+    std::vector<G4String> sd_names_;
+    std::vector<Sensor> sensors_;
+    std::vector<uint32_t> offsets_;
+    std::vector<Entry> entries_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline size_t ELSensorKernel::GetNumberOfSensors() const { return sensors_.size(); }
+  inline const ELSensorKernel::Sensor& ELSensorKernel::GetSensor(size_t i) const
+  { return sensors_[i]; }
+
+  inline size_t ELSensorKernel::GetNumberOfSensitiveDetectors() const
+  { return sd_names_.size(); }
+  inline const G4String& ELSensorKernel::GetSensitiveDetectorName(size_t i) const
+  { return sd_names_[i]; }
+
+} // end namespace nexus
+
+#endif
@@ -10,6 +10,9 @@
 
 #include "IonizationElectron.h"
 #include "BaseDriftField.h"
+#include "EventStats.h"
+#include "ELSensorKernel.h"
+#include "SensorSD.h"
 
 #include <G4MaterialPropertiesTable.hh>
 #include <G4ParticleChange.hh>
@@ -17,9 +20,17 @@
 #include <Randomize.hh>
 #include <G4Poisson.hh>
 #include <G4GenericMessenger.hh>
+#include <G4RunManager.hh>
+#include <G4Event.hh>
+#include <G4Run.hh>
+#include <G4SDManager.hh>
+#include <G4HCofThisEvent.hh>
 
 #include <CLHEP/Units/PhysicalConstants.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace nexus;
 using namespace CLHEP;
 
@@ -28,7 +39,9 @@ using namespace CLHEP;
 Electroluminescence::Electroluminescence(const G4String& process_name,
 					                               G4ProcessType type):
   G4VDiscreteProcess(process_name, type), theFastIntegralTable_(0),
-  table_generation_(false), photons_per_point_(0)
+  table_generation_(false), photons_per_point_(0),
+  mode_("full"), kernel_file_(""), kernel_(nullptr),
+  run_id_(-1), event_id_(-1)
 {
   ParticleChange_ = new G4ParticleChange();
   pParticleChange = ParticleChange_;
@@ -43,6 +56,15 @@ Electroluminescence::Electroluminescence(const G4String& process_name,
   msg_->DeclareProperty("photons_per_point", photons_per_point_,
 			"Photon per point");
 
+  G4GenericMessenger::Command& mode_cmd =
+    msg_->DeclareProperty("mode", mode_,
+      "EL light simulation: full (optical photons) or kernel (sensor hits "
+      "from the light-transport kernel of the EL gap).");
+  mode_cmd.SetCandidates("full kernel");
+
+  msg_->DeclareProperty("kernel_file", kernel_file_,
+    "Light-transport kernel of the EL gap used in kernel mode.");
+
  }
 
 
@@ -50,6 +72,7 @@ Electroluminescence::Electroluminescence(const G4String& process_name,
 Electroluminescence::~Electroluminescence()
 {
   delete theFastIntegralTable_;
+  delete kernel_;
 }
 
 
@@ -87,6 +110,11 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   // Generate a random number of photons around mean 'yield'
   G4double mean = yield * step_length;
 
+  if (mode_ == "kernel") {
+    FillSensorHits(step, mean);
+    return G4VDiscreteProcess::PostStepDoIt(track, step);
+  }
+
   G4int num_photons;
 
   if (yield < 10.) { // Poissonian regime
@@ -131,6 +159,8 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
 
   G4double sc_max = spectrum_integral->GetMaxValue();
 
+  EventStats::AddELPhotons(num_photons);
+
   for (G4int i=0; i<num_photons; i++) {
     // Generate a random direction for the photon
     // (EL is supposed isotropic)
@@ -189,6 +219,119 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
 
 
 
+void Electroluminescence::FillSensorHits(const G4Step& step, G4double mean_photons)
+{
+  if (!kernel_) {
+    if (kernel_file_ == "")
+      G4Exception("[Electroluminescence]", "FillSensorHits()", FatalException,
+                  "Kernel mode requires a kernel file.");
+    kernel_ = new ELSensorKernel(kernel_file_);
+    sensor_hits_.assign(kernel_->GetNumberOfSensors(), nullptr);
+  }
+
+  // The light seen by the sensors depends on where the drift line
+  // enters the gap
+  G4ThreeVector position = step.GetPreStepPoint()->GetPosition();
+  size_t n;
+  const ELSensorKernel::Entry* entries = kernel_->Lookup(position.x(), position.y(), n);
+  if (!entries) return;
+
+  // Hits collections are created anew in every event. Event IDs start
+  // again from 0 in every run (and the collections may be allocated at
+  // the same address), so the cache is keyed on both run and event.
+  G4RunManager* runmgr = G4RunManager::GetRunManager();
+  const G4Event* event = runmgr->GetCurrentEvent();
+  G4HCofThisEvent* hce = event->GetHCofThisEvent();
+  if (!hce) return;
+  G4int run_id = runmgr->GetCurrentRun()->GetRunID();
+  if (run_id != run_id_ || event->GetEventID() != event_id_) {
+    run_id_   = run_id;
+    event_id_ = event->GetEventID();
+    std::fill(sensor_hits_.begin(), sensor_hits_.end(), nullptr);
+  }
+
+  // Photons are emitted uniformly while the electron crosses the gap
+  G4double t0 = step.GetPreStepPoint()->GetGlobalTime();
+  G4double t1 = step.GetPostStepPoint()->GetGlobalTime();
+
+  for (size_t i=0; i<n; ++i) {
+    G4double expected = mean_photons * entries[i].probability;
+    if (expected <= 0.) continue;
+
+    SensorHit* hit = GetSensorHit(entries[i].sensor, hce);
+    G4double bin_size = hit->GetBinSize();
+
+    if (t1 <= t0 || bin_size <= 0.) {
+      G4int counts = SampleCounts(expected);
+      if (counts > 0) hit->Fill(t0, counts);
+      EventStats::AddDetectedPhotons(counts);
+      continue;
+    }
+
+    // Time profile: the counts of each time bin are sampled
+    // according to the fraction of the crossing time it covers
+    G4double bin_start = std::floor(t0/bin_size) * bin_size;
+    for (G4double start=bin_start; start<t1; start+=bin_size) {
+      G4double from = std::max(start, t0);
+      G4double to   = std::min(start + bin_size, t1);
+      G4int counts = SampleCounts(expected * (to - from) / (t1 - t0));
+      if (counts > 0) hit->Fill(from, counts);
+      EventStats::AddDetectedPhotons(counts);
+    }
+  }
+}
+
+
+
+SensorHit* Electroluminescence::GetSensorHit(size_t i, G4HCofThisEvent* hce)
+{
+  if (sensor_hits_[i]) return sensor_hits_[i];
+
+  const ELSensorKernel::Sensor& sensor = kernel_->GetSensor(i);
+  const G4String& sdname = kernel_->GetSensitiveDetectorName(sensor.sd_index);
+
+  G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
+  SensorSD* sd = dynamic_cast<SensorSD*>(sdmgr->FindSensitiveDetector(sdname, false));
+  G4int hcid = sdmgr->GetCollectionID(sdname + "/" + SensorSD::GetCollectionUniqueName());
+  SensorHitsCollection* hc = (sd && hcid >= 0) ?
+    dynamic_cast<SensorHitsCollection*>(hce->GetHC(hcid)) : nullptr;
+  if (!hc) {
+    G4String msg = "No sensor hits collection for sensitive detector " + sdname;
+    G4Exception("[Electroluminescence]", "GetSensorHit()", FatalException, msg);
+  }
+
+  // The sensitive detector may have created the hit already
+  for (size_t j=0; j<hc->entries(); ++j) {
+    if ((*hc)[j]->GetPmtID() == sensor.id) {
+      sensor_hits_[i] = (*hc)[j];
+      return sensor_hits_[i];
+    }
+  }
+
+  SensorHit* hit = new SensorHit();
+  hit->SetPmtID(sensor.id);
+  hit->SetBinSize(sd->GetTimeBinning());
+  hit->SetPosition(sensor.position);
+  hc->insert(hit);
+
+  sensor_hits_[i] = hit;
+  return hit;
+}
+
+
+
+G4int Electroluminescence::SampleCounts(G4double mean) const
+{
+  if (mean < 10.) // Poissonian regime
+    return G4int(G4Poisson(mean));
+
+  // Gaussian regime
+  G4int counts = G4int(G4RandGauss::shoot(mean, sqrt(mean)) + 0.5);
+  return std::max(counts, 0);
+}
+
+
+
 void Electroluminescence::BuildThePhysicsTable()
 {
   if (theFastIntegralTable_) return;
@@ -12,12 +12,19 @@
 #include <G4VDiscreteProcess.hh>
 #include <G4PhysicsOrderedFreeVector.hh>
 
+#include "SensorHit.h"
+
+#include <vector>
+
 class G4ParticleChange;
 class G4GenericMessenger;
+class G4HCofThisEvent;
 
 
 namespace nexus {
 
+  class ELSensorKernel;
+
   class Electroluminescence: public G4VDiscreteProcess
   {
   public:
@@ -43,6 +50,16 @@ namespace nexus {
     /// invoked at every step.
     G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
 
+    /// Add the light detected from the EL step straight to the sensor
+    /// hits, using the light-transport kernel of the EL gap, instead
+    /// of generating optical photons
+    void FillSensorHits(const G4Step&, G4double mean_photons);
+    /// Return the hit of sensor i of the kernel in the current event,
+    /// creating it if needed
+    SensorHit* GetSensorHit(size_t i, G4HCofThisEvent*);
+    /// Number of detected photons for a given mean
+    G4int SampleCounts(G4double mean) const;
+
     void BuildThePhysicsTable();
     void ComputeCumulativeDistribution(const G4PhysicsOrderedFreeVector&,
                                        G4PhysicsOrderedFreeVector&);
@@ -56,6 +73,14 @@ namespace nexus {
 
     G4bool table_generation_;
     G4int photons_per_point_;
+
+    G4String mode_;        ///< full (optical photons) or kernel
+    G4String kernel_file_; ///< Light-transport kernel of the EL gap
+    ELSensorKernel* kernel_;
+
+    G4int run_id_;   ///< Run of the event the cached hits belong to
+    G4int event_id_; ///< Event the cached hits belong to
+    std::vector<SensorHit*> sensor_hits_; ///< Hits per kernel sensor
   };
 
 } // end namespace nexus
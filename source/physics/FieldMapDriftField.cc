@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------------------
+// nexus | FieldMapDriftField.cc
+//
+// Drift field described by a precomputed map of drift lines. For each
+// node of a regular 3D grid, the map gives the end point of the drift
+// line, the drift time, the length of the line and the transverse and
+// time spreads due to diffusion. Drifting an electron interpolates the
+// map trilinearly, so it takes constant time whatever the shape of
+// the field lines.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "FieldMapDriftField.h"
+#include "SegmentPointSampler.h"
+
+#include <G4Exception.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include "CLHEP/Units/SystemOfUnits.h"
+
+
+namespace {
+
+  struct FieldMapHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t n[3];
+    uint32_t reserved;
+    double   min[3];
+    double   step[3];
+  };
+
+}
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+
+  FieldMapDriftField::FieldMapDriftField(const G4String& filename, EAxis axis):
+    BaseDriftField(), axis_(axis), light_yield_(0.)
+  {
+    Load(filename);
+
+    // initialize random generator with dummy values
+    rnd_ = new SegmentPointSampler(G4LorentzVector(0.,0.,0.,-999.),
+                                   G4LorentzVector(0.,0.,0.,-999.));
+  }
+
+
+
+  FieldMapDriftField::~FieldMapDriftField()
+  {
+    delete rnd_;
+  }
+
+
+
+  void FieldMapDriftField::Load(const G4String& filename)
+  {
+    std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (!in) {
+      G4String msg = "Cannot open drift field map " + filename;
+      G4Exception("[FieldMapDriftField]", "Load()", FatalException, msg);
+    }
+    const std::streamoff file_size = in.tellg();
+    in.seekg(0);
+
+    FieldMapHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, "NDFM", 4) != 0 || header.version != 1) {
+      G4String msg = filename + " is not a drift field map.";
+      G4Exception("[FieldMapDriftField]", "Load()", FatalException, msg);
+    }
+
+    for (G4int i=0; i<3; ++i) {
+      if (header.n[i] < 2 || header.step[i] <= 0.) {
+        G4String msg = "Invalid grid in drift field map " + filename;
+        G4Exception("[FieldMapDriftField]", "Load()", FatalException, msg);
+      }
+      n_[i]    = header.n[i];
+      min_[i]  = header.min[i] * mm;
+      step_[i] = header.step[i] * mm;
+    }
+
+    // The size of the grid is checked against the file before allocating it
+    uint64_t n_values = uint64_t(header.n[0]) * header.n[1] * header.n[2] * kNValues;
+    if (n_values * sizeof(float) > uint64_t(file_size - in.tellg())) {
+      G4String msg = "Drift field map " + filename + " is truncated.";
+      G4Exception("[FieldMapDriftField]", "Load()", FatalException, msg);
+    }
+
+    data_.resize(n_values);
+    in.read(reinterpret_cast<char*>(data_.data()), data_.size() * sizeof(float));
+    if (!in) {
+      G4String msg = "Drift field map " + filename + " is truncated.";
+      G4Exception("[FieldMapDriftField]", "Load()", FatalException, msg);
+    }
+  }
+
+
+
+  void FieldMapDriftField::Write(const G4String& filename, const size_t n[3],
+                                 const G4double min[3], const G4double step[3],
+                                 const std::vector<float>& records)
+  {
+    FieldMapHeader header;
+    std::memcpy(header.magic, "NDFM", 4);
+    header.version  = 1;
+    header.reserved = 0;
+    for (G4int i=0; i<3; ++i) {
+      header.n[i]    = n[i];
+      header.min[i]  = min[i] / mm;
+      header.step[i] = step[i] / mm;
+    }
+
+    if (records.size() != n[0] * n[1] * n[2] * kNValues)
+      G4Exception("[FieldMapDriftField]", "Write()", FatalException,
+                  "The number of records does not match the grid.");
+
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(float));
+    if (!out) {
+      G4String msg = "Cannot write drift field map " + filename;
+      G4Exception("[FieldMapDriftField]", "Write()", FatalException, msg);
+    }
+  }
+
+
+
+  G4double FieldMapDriftField::Drift(G4LorentzVector& xyzt)
+  {
+    // Cell containing the point and fractional position within it
+    size_t idx[3];
+    G4double frac[3];
+    for (G4int i=0; i<3; ++i) {
+      G4double u = (xyzt[i] - min_[i]) / step_[i];
+      if (u < 0. || u > n_[i] - 1) return 0.;
+      idx[i] = std::min(size_t(u), n_[i] - 2);
+      frac[i] = u - idx[i];
+    }
+
+    // Trilinear interpolation of the drift line parameters
+    G4double values[kNValues] = {0.};
+    for (G4int corner=0; corner<8; ++corner) {
+      G4int di = corner & 1, dj = (corner >> 1) & 1, dk = (corner >> 2) & 1;
+      const float* node = Node(idx[0] + di, idx[1] + dj, idx[2] + dk);
+
+      // Lost drift lines cannot be interpolated
+      if (node[3] < 0.) return 0.;
+
+      G4double w = (di ? frac[0] : 1. - frac[0]) *
+                   (dj ? frac[1] : 1. - frac[1]) *
+                   (dk ? frac[2] : 1. - frac[2]);
+      for (size_t v=0; v<kNValues; ++v) values[v] += w * node[v];
+    }
+
+    G4double drift_time   = values[3] * microsecond;
+    G4double path_length  = values[4] * mm;
+    G4double transv_sigma = values[5] * mm;
+    G4double time_sigma   = values[6] * microsecond;
+
+    G4ThreeVector position;
+    for (G4int i=0; i<3; ++i) {
+      position[i] = values[i] * mm;
+      // Transverse diffusion in the anode plane
+      if (i != axis_)
+        position[i] = G4RandGauss::shoot(position[i], transv_sigma);
+    }
+
+    G4double time = xyzt.t() + drift_time + G4RandGauss::shoot(0., time_sigma);
+    if (time < xyzt.t()) time = xyzt.t() + drift_time;
+
+    // Without a path length in the map, use the distance to the end point
+    if (path_length <= 0.) path_length = (position - xyzt.vect()).mag();
+
+    xyzt.set(time, position);
+
+    return path_length;
+  }
+
+
+
+  G4LorentzVector FieldMapDriftField::GeneratePointAlongDriftLine
+  (const G4LorentzVector& origin, const G4LorentzVector& end)
+  {
+    // The drift line is approximated by the segment between its ends
+    rnd_->SetPoints(origin, end);
+    return rnd_->Shoot();
+  }
+
+} // end namespace nexus
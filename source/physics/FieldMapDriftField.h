@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+// nexus | FieldMapDriftField.h
+//
+// Drift field described by a precomputed map of drift lines. For each
+// node of a regular 3D grid, the map gives the end point of the drift
+// line, the drift time, the length of the line and the transverse and
+// time spreads due to diffusion. Drifting an electron interpolates the
+// map trilinearly, so it takes constant time whatever the shape of
+// the field lines.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef FIELD_MAP_DRIFT_FIELD_H
+#define FIELD_MAP_DRIFT_FIELD_H
+
+#include "BaseDriftField.h"
+
+#include <geomdefs.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class SegmentPointSampler;
+
+  /// The map is a binary file made of a header followed by one record
+  /// per grid node, with x running fastest and z slowest. Coordinates
+  /// are global, in mm, and times in microseconds.
+  ///
+  ///   header: char magic[4] = "NDFM", uint32 version = 1,
+  ///           uint32 nx, ny, nz, uint32 reserved = 0,
+  ///           float64 min_x, min_y, min_z,
+  ///           float64 step_x, step_y, step_z
+  ///   record: float32 end_x, end_y, end_z, drift_time, path_length,
+  ///           transverse_sigma, time_sigma
+  ///
+  /// Drift lines that do not reach the anode (e.g. ending on the field
+  /// cage) are flagged with a negative drift time.
+
+  class FieldMapDriftField: public BaseDriftField
+  {
+  public:
+    /// Constructor providing the map file and the axis
+    /// parallel to the drift direction at the anode
+    FieldMapDriftField(const G4String& filename, EAxis axis=kZAxis);
+    /// Destructor
+    ~FieldMapDriftField();
+
+    /// Calculate final position and time of an ionization electron.
+    /// Returns zero (the electron is lost) outside the map
+    /// or on drift lines that do not reach the anode.
+    G4double Drift(G4LorentzVector& xyzt);
+
+    G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&);
+
+    void SetLightYield(G4double);
+    virtual G4double LightYield() const;
+
+    /// All drift lines in the map end on the anode
+    virtual G4bool HasFixedDestination() const;
+
+    /// Write a map in the format read by the constructor. The grid is
+    /// given in Geant4 units and the records (kNValues per node, in mm
+    /// and microseconds) in the order of the file.
+    static void Write(const G4String& filename, const size_t n[3],
+                      const G4double min[3], const G4double step[3],
+                      const std::vector<float>& records);
+
+    /// Number of float values per grid node
+    static constexpr size_t kNValues = 7;
+
+  private:
+    void Load(const G4String& filename);
+    const float* Node(size_t i, size_t j, size_t k) const;
+
+  private:
+    EAxis axis_; ///< Axis parallel to field lines at the anode
+
+    size_t n_[3];     ///< Number of nodes per axis
+    G4double min_[3]; ///< Position of the first node
+    G4double step_[3];///< Distance between nodes
+
+    std::vector<float> data_;
+
+    G4double light_yield_;
+
+    SegmentPointSampler* rnd_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline const float* FieldMapDriftField::Node(size_t i, size_t j, size_t k) const
+  { return &data_[((k * n_[1] + j) * n_[0] + i) * kNValues]; }
+
+  inline void FieldMapDriftField::SetLightYield(G4double ly) { light_yield_ = ly; }
+  inline G4double FieldMapDriftField::LightYield() const { return light_yield_; }
+  inline G4bool FieldMapDriftField::HasFixedDestination() const { return true; }
+
+} // end namespace nexus
+
+#endif
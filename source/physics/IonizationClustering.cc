@@ -11,6 +11,7 @@
 #include "BaseDriftField.h"
 #include "IonizationElectron.h"
 #include "SegmentPointSampler.h"
+#include "EventStats.h"
 
 #include <G4ParticleDefinition.hh>
 #include <G4OpticalPhoton.hh>
@@ -132,6 +133,7 @@ namespace nexus {
     }
 
     ParticleChange_->SetNumberOfSecondaries(num_charges);
+    EventStats::AddIonizationElectrons(num_charges);
 
     // Track secondaries first
     if ((track.GetTrackStatus() == fAlive) && num_charges > 0)
@@ -17,13 +17,19 @@
 #include <G4TransportationManager.hh>
 #include <G4TouchableHandle.hh>
 #include <G4Navigator.hh>
+#include <G4NavigationHistory.hh>
+#include <G4AffineTransform.hh>
+#include <G4VSolid.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
 
 
 namespace nexus {
 
 
   IonizationDrift::IonizationDrift(const G4String& name, G4ProcessType type):
-    G4VContinuousDiscreteProcess(name, type)
+    G4VContinuousDiscreteProcess(name, type),
+    field_(nullptr), attach_material_(nullptr), attachment_(-1.)
   {
     ParticleChange_ = new G4ParticleChangeForTransport();
     pParticleChange = ParticleChange_;
@@ -55,16 +61,15 @@ namespace nexus {
     G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
     
     // Get the drift field attached to this region
-    BaseDriftField* field = 
-      dynamic_cast<BaseDriftField*>(region->GetUserInformation());
+    field_ = dynamic_cast<BaseDriftField*>(region->GetUserInformation());
 
     // If the region has no field, the particle won't move 
     // and therefore the step length is zero.
-    if (!field) return step_length;
+    if (!field_) return step_length;
 
     // Get displacement from current position due to drift field
     xyzt_.set(track.GetGlobalTime(), track.GetPosition());
-    step_length = field->Drift(xyzt_);
+    step_length = field_->Drift(xyzt_);
     
     return step_length;
   }
@@ -80,19 +85,27 @@ namespace nexus {
 
     if (step.GetStepLength() > 0) {
 
-      // Simulate attachment by impurities
-      
-      G4MaterialPropertiesTable* mpt = 
-        track.GetMaterial()->GetMaterialPropertiesTable();
-
-      if (!mpt || !(mpt->ConstPropertyExists("ATTACHMENT"))) { 
-        G4Exception("[IonizationDrift]", "AlongStepDoIt()", JustWarning,
-          "No material properties table found. Assuming no attachment.");
+      // Simulate attachment by impurities. The attachment of the
+      // material is looked up only when the material changes.
+
+      const G4Material* material = track.GetMaterial();
+      if (material != attach_material_) {
+        attach_material_ = material;
+        attachment_ = -1.;
+
+        G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+        if (!mpt || !(mpt->ConstPropertyExists("ATTACHMENT"))) {
+          G4Exception("[IonizationDrift]", "AlongStepDoIt()", JustWarning,
+            "No material properties table found. Assuming no attachment.");
+        }
+        else {
+          attachment_ = mpt->GetConstProperty("ATTACHMENT");
+        }
       }
-      else {
-        const G4double attach = mpt->GetConstProperty("ATTACHMENT");
-        G4double rnd = -attach * log(G4UniformRand());
-        if (xyzt_.t() > rnd) 
+
+      if (attachment_ >= 0.) {
+        G4double rnd = -attachment_ * log(G4UniformRand());
+        if (xyzt_.t() > rnd)
           ParticleChange_->ProposeTrackStatus(fStopAndKill);
       }
 
@@ -125,10 +138,29 @@ namespace nexus {
   {
     ParticleChange_->Initialize(track);
 
-    // Update navigator and touchable handle
+    // Electrons attached or outside a drift field have been killed
+    // along the step and need not be relocated
+    if (track.GetTrackStatus() == fStopAndKill)
+      return G4VContinuousDiscreteProcess::PostStepDoIt(track, step);
+
     G4TouchableHandle touchable = track.GetTouchableHandle();
-    nav_->LocateGlobalPointAndUpdateTouchableHandle
-      (track.GetPosition(), track.GetMomentumDirection(), touchable, false);
+
+    // Drift lines of fields with a fixed destination end in the same
+    // volume, whose touchable is reused while the end point lies in it
+    auto cached = field_ && field_->HasFixedDestination() ?
+      destinations_.find(field_) : destinations_.end();
+
+    if (cached != destinations_.end() && Contains(cached->second, track.GetPosition())) {
+      touchable = cached->second;
+    }
+    else {
+      // Update navigator and touchable handle
+      nav_->LocateGlobalPointAndUpdateTouchableHandle
+        (track.GetPosition(), track.GetMomentumDirection(), touchable, false);
+
+      if (field_ && field_->HasFixedDestination() && touchable->GetVolume())
+        destinations_[field_] = touchable;
+    }
     ParticleChange_->SetTouchableHandle(touchable);
     
     // Get the volume where the particle currently lives
@@ -150,4 +182,32 @@ namespace nexus {
   }
 
   
+
+
+  G4bool IonizationDrift::Contains(const G4TouchableHandle& touchable,
+                                   const G4ThreeVector& position) const
+  {
+    const G4VPhysicalVolume* volume = touchable->GetVolume();
+    if (!volume) return false;
+
+    G4ThreeVector local =
+      touchable->GetHistory()->GetTopTransform().TransformPoint(position);
+
+    const G4LogicalVolume* lv = volume->GetLogicalVolume();
+    if (lv->GetSolid()->Inside(local) != kInside) return false;
+
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+      const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+      if (daughter->IsReplicated()) return false;
+
+      G4AffineTransform transform(daughter->GetRotation(), daughter->GetTranslation());
+      transform.Invert();
+      if (daughter->GetLogicalVolume()->GetSolid()->
+          Inside(transform.TransformPoint(local)) != kOutside)
+        return false;
+    }
+
+    return true;
+  }
+
 } // end namespace nexus
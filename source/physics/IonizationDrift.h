@@ -11,13 +11,19 @@
 #define IONIZATION_DRIFT_H
 
 #include <G4VContinuousDiscreteProcess.hh>
+#include <G4TouchableHandle.hh>
+
+#include <map>
 
 
 class G4Navigator;
 class G4ParticleChangeForTransport;
+class G4Material;
 
 namespace nexus {
 
+  class BaseDriftField;
+
   class IonizationDrift: public G4VContinuousDiscreteProcess
   {
   public:
@@ -46,10 +52,21 @@ namespace nexus {
     G4double GetContinuousStepLimit(const G4Track&, G4double,
 				    G4double, G4double&);
 
+    /// Returns true if the point lies in the volume of the touchable
+    /// and not in any of its daughters
+    G4bool Contains(const G4TouchableHandle&, const G4ThreeVector&) const;
+
   private:
     G4LorentzVector xyzt_;
     G4ParticleChangeForTransport* ParticleChange_;
     G4Navigator* nav_; ///< Pointer to the G4 navigator for tracking
+
+    BaseDriftField* field_; ///< Drift field of the current step
+    /// Touchable where the drift lines of each field end
+    std::map<const BaseDriftField*, G4TouchableHandle> destinations_;
+
+    const G4Material* attach_material_; ///< Material of the cached attachment
+    G4double attachment_; ///< Attachment of attach_material_ (negative if none)
   };
 
 } // end namespace nexus
@@ -64,6 +64,9 @@ namespace nexus {
     void SetNumberOfPhotons(G4double);
     G4double GetNumberOfPhotons() const;
 
+    /// All drift lines end just past the anode plane
+    virtual G4bool HasFixedDestination() const;
+
   private:
     /// Returns true if coordinate is between anode and cathode
     G4bool CheckCoordinate(G4double);
@@ -136,6 +139,9 @@ namespace nexus {
   inline void UniformElectricDriftField::SetNumberOfPhotons(G4double nph)
   { num_ph_ = nph; }
 
+  inline G4bool UniformElectricDriftField::HasFixedDestination() const
+  { return true; }
+
 
 
 } // end namespace nexus
@@ -0,0 +1,164 @@
+// ----------------------------------------------------------------------------
+// nexus | ImportanceBiasingPhysics.cc
+//
+// Physics constructor that sets up geometry-cell importance biasing
+// (splitting and Russian roulette at volume boundaries) in the mass
+// geometry. Importances are assigned per region from the configuration
+// macros; volumes without one take the importance of their mother.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ImportanceBiasingPhysics.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4GeometrySampler.hh>
+#include <G4IStore.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
+#include <G4ParticleTable.hh>
+#include <G4PhysicsConstructorFactory.hh>
+
+#include <sstream>
+
+
+namespace nexus {
+
+  /// Macro that allows the use of this physics constructor
+  /// with the generic physics list
+  G4_DECLARE_PHYSCONSTR_FACTORY(ImportanceBiasingPhysics);
+
+
+
+  ImportanceBiasingPhysics::ImportanceBiasingPhysics():
+    G4VPhysicsConstructor("ImportanceBiasingPhysics"), msg_(nullptr)
+  {
+    msg_ = new G4GenericMessenger(this, "/PhysicsList/ImportanceBiasing/",
+      "Control commands of the geometry importance biasing.");
+
+    msg_->DeclareMethod("particle", &ImportanceBiasingPhysics::AddParticle,
+      "Add a particle to be biased (e.g. neutron, gamma).");
+
+    msg_->DeclareMethod("importance", &ImportanceBiasingPhysics::SetImportance,
+      "Set the importance of the volumes of a region: region value.");
+  }
+
+
+
+  ImportanceBiasingPhysics::~ImportanceBiasingPhysics()
+  {
+    for (auto sampler: samplers_) delete sampler;
+    delete msg_;
+  }
+
+
+
+  void ImportanceBiasingPhysics::AddParticle(G4String name)
+  {
+    particles_.push_back(name);
+  }
+
+
+
+  void ImportanceBiasingPhysics::SetImportance(G4String params)
+  {
+    std::istringstream iss(params);
+    G4String region;
+    G4double importance;
+    if (!(iss >> region >> importance) || importance <= 0.)
+      G4Exception("[ImportanceBiasingPhysics]", "SetImportance()", FatalException,
+                  "Expected: region value, with a positive importance.");
+
+    importances_[region] = importance;
+  }
+
+
+
+  void ImportanceBiasingPhysics::ConstructParticle()
+  {
+  }
+
+
+
+  void ImportanceBiasingPhysics::ConstructProcess()
+  {
+    if (particles_.empty()) {
+      G4Exception("[ImportanceBiasingPhysics]", "ConstructProcess()", JustWarning,
+                  "No particles selected: importance biasing is not active.");
+      return;
+    }
+
+    for (const auto& imp: importances_) {
+      if (!G4RegionStore::GetInstance()->GetRegion(imp.first, false)) {
+        G4String msg = "Region " + imp.first + " not found in the geometry.";
+        G4Exception("[ImportanceBiasingPhysics]", "ConstructProcess()",
+                    FatalException, msg);
+      }
+    }
+
+    // The geometry is already constructed at this point, so the
+    // importance store can be filled for the whole mass geometry
+    G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->
+      GetNavigatorForTracking()->GetWorldVolume();
+
+    G4IStore* istore = G4IStore::GetInstance();
+    std::set<const G4VPhysicalVolume*> done;
+    FillImportanceStore(istore, world, 1., done);
+
+    for (const auto& name: particles_) {
+      if (!G4ParticleTable::GetParticleTable()->FindParticle(name)) {
+        G4String msg = "Unknown particle " + name;
+        G4Exception("[ImportanceBiasingPhysics]", "ConstructProcess()",
+                    FatalException, msg);
+      }
+
+      G4GeometrySampler* sampler = new G4GeometrySampler(world, name);
+      sampler->SetParallel(false);
+      sampler->PrepareImportanceSampling(istore, 0);
+      sampler->Configure();
+      samplers_.push_back(sampler);
+    }
+  }
+
+
+
+  void ImportanceBiasingPhysics::FillImportanceStore(G4IStore* istore,
+                                                     const G4VPhysicalVolume* pv,
+                                                     G4double importance,
+                                                     std::set<const G4VPhysicalVolume*>& done) const
+  {
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+    // Volumes take the importance of their mother unless they are
+    // the root of a region with an importance of its own
+    if (lv->IsRootRegion()) {
+      auto it = importances_.find(lv->GetRegion()->GetName());
+      if (it != importances_.end()) importance = it->second;
+    }
+
+    // A physical volume is reached once per placement of its mother,
+    // but its cells only have to be registered once
+    if (done.insert(pv).second) {
+      if (pv->IsReplicated()) {
+        EAxis axis;
+        G4int nreplicas;
+        G4double width, offset;
+        G4bool consuming;
+        pv->GetReplicationData(axis, nreplicas, width, offset, consuming);
+        for (G4int i=0; i<nreplicas; ++i)
+          istore->AddImportanceGeometryCell(importance, *pv, i);
+      }
+      else {
+        istore->AddImportanceGeometryCell(importance, *pv, pv->GetCopyNo());
+      }
+    }
+
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i)
+      FillImportanceStore(istore, lv->GetDaughter(i), importance, done);
+  }
+
+} // end namespace nexus
@@ -0,0 +1,64 @@
+// ----------------------------------------------------------------------------
+// nexus | ImportanceBiasingPhysics.h
+//
+// Physics constructor that sets up geometry-cell importance biasing
+// (splitting and Russian roulette at volume boundaries) in the mass
+// geometry. Importances are assigned per region from the configuration
+// macros; volumes without one take the importance of their mother.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef IMPORTANCE_BIASING_PHYSICS_H
+#define IMPORTANCE_BIASING_PHYSICS_H
+
+#include <G4VPhysicsConstructor.hh>
+
+#include <map>
+#include <set>
+#include <vector>
+
+class G4GenericMessenger;
+class G4GeometrySampler;
+class G4IStore;
+class G4VPhysicalVolume;
+
+
+namespace nexus {
+
+  class ImportanceBiasingPhysics: public G4VPhysicsConstructor
+  {
+  public:
+    /// Constructor
+    ImportanceBiasingPhysics();
+    /// Destructor
+    ~ImportanceBiasingPhysics();
+
+    /// Construct all required particles (Geant4 mandatory method)
+    virtual void ConstructParticle();
+    /// Construct all required physics processes (Geant4 mandatory method)
+    virtual void ConstructProcess();
+
+  private:
+    /// Add a particle to be biased
+    void AddParticle(G4String);
+    /// Set the importance of a region, given as "region value"
+    void SetImportance(G4String);
+
+    /// Assign an importance to every cell of the geometry tree
+    /// below pv, given the importance of its mother
+    void FillImportanceStore(G4IStore*, const G4VPhysicalVolume* pv,
+                             G4double importance,
+                             std::set<const G4VPhysicalVolume*>& done) const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    std::vector<G4String> particles_;              ///< Biased particles
+    std::map<G4String, G4double> importances_;     ///< Importance per region
+    std::vector<G4GeometrySampler*> samplers_;
+  };
+
+} // end namespace nexus
+
+#endif
@@ -2,6 +2,9 @@
 // nexus | IonizationSD.cc
 //
 // This class is the sensitive detector that creates ionization hits.
+// Optionally, the energy deposits can be accumulated in a 3D grid of
+// voxels (per track or per event) so that only one hit per voxel is
+// created.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -17,11 +20,17 @@
 #include <G4Step.hh>
 #include <G4OpticalPhoton.hh>
 
+#include <algorithm>
+#include <cmath>
+
 
 
 using namespace nexus;
 
 
+G4ThreeVector IonizationSD::voxel_size_ = G4ThreeVector(0., 0., 0.);
+G4bool IonizationSD::voxel_per_track_ = true;
+
 
 IonizationSD::IonizationSD(const G4String& name):
   G4VSensitiveDetector(name), include_(true)
@@ -57,6 +66,7 @@ void IonizationSD::Initialize(G4HCofThisEvent* hce)
     G4SDManager::GetSDMpointer()->GetCollectionID(SensitiveDetectorName+"/"+collectionName[0]);
   hce->AddHitsCollection(hcid, IHC_);
 
+  voxels_.clear();
 }
 
 
@@ -74,15 +84,22 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   // Discard steps where no energy was deposited in the detector
   if (edep <= 0.) return false;
 
-  // Create a hit and set its properties
-  IonizationHit* hit = new IonizationHit();
-  hit->SetTrackID(step->GetTrack()->GetTrackID());
-  hit->SetTime(step->GetTrack()->GetGlobalTime());
-  hit->SetEnergyDeposit(edep);
-  hit->SetPosition(step->GetPostStepPoint()->GetPosition());
-
-  // Add hit to collection
-  IHC_->insert(hit);
+  if (voxel_size_.x() > 0. && voxel_size_.y() > 0. && voxel_size_.z() > 0.) {
+    AddToVoxel(track->GetTrackID(), step->GetPostStepPoint()->GetPosition(),
+               track->GetGlobalTime(), edep, track->GetWeight());
+  }
+  else {
+    // Create a hit and set its properties
+    IonizationHit* hit = new IonizationHit();
+    hit->SetTrackID(step->GetTrack()->GetTrackID());
+    hit->SetTime(step->GetTrack()->GetGlobalTime());
+    hit->SetEnergyDeposit(edep);
+    hit->SetPosition(step->GetPostStepPoint()->GetPosition());
+    hit->SetWeight(step->GetTrack()->GetWeight());
+
+    // Add hit to collection
+    IHC_->insert(hit);
+  }
 
   // Add energy deposit to the trajectory associated
   // to the current track
@@ -100,6 +117,41 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 
 
+void IonizationSD::AddToVoxel(G4int track_id, const G4ThreeVector& pos,
+                             G4double time, G4double edep, G4double weight)
+{
+  VoxelKey key;
+  key.track_id = voxel_per_track_ ? track_id : -1;
+  key.i = G4int(std::floor(pos.x() / voxel_size_.x()));
+  key.j = G4int(std::floor(pos.y() / voxel_size_.y()));
+  key.k = G4int(std::floor(pos.z() / voxel_size_.z()));
+
+  auto it = voxels_.find(key);
+  if (it == voxels_.end()) {
+    IonizationHit* hit = new IonizationHit();
+    hit->SetTrackID(key.track_id);
+    hit->SetTime(time);
+    hit->SetEnergyDeposit(edep);
+    hit->SetPosition(pos);
+    hit->SetWeight(weight);
+    IHC_->insert(hit);
+    voxels_[key] = hit;
+    return;
+  }
+
+  // The hit keeps the earliest time and the energy-weighted
+  // mean position and weight of the deposits in the voxel
+  IonizationHit* hit = it->second;
+  G4double total = hit->GetEnergyDeposit() + edep;
+  G4double f = edep / total;
+  hit->SetPosition(hit->GetPosition() + f * (pos - hit->GetPosition()));
+  hit->SetWeight(hit->GetWeight() + f * (weight - hit->GetWeight()));
+  hit->SetTime(std::min(hit->GetTime(), time));
+  hit->SetEnergyDeposit(total);
+}
+
+
+
 void IonizationSD::EndOfEvent(G4HCofThisEvent*)
 {
 }
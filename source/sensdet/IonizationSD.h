@@ -2,6 +2,9 @@
 // nexus | IonizationSD.h
 //
 // This class is the sensitive detector that creates ionization hits.
+// Optionally, the energy deposits can be accumulated in a 3D grid of
+// voxels (per track or per event) so that only one hit per voxel is
+// created.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -12,6 +15,9 @@
 #include <G4VSensitiveDetector.hh>
 #include "IonizationHit.h"
 
+#include <G4ThreeVector.hh>
+#include <unordered_map>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
@@ -42,19 +48,57 @@ namespace nexus {
 
     void IncludeInTotalEnergyDeposit(G4bool);
 
+    /// Set the size of the voxels in which the energy deposits of all
+    /// ionization sensitive detectors are accumulated. A null size
+    /// (default) disables the voxelization: one hit is created per step.
+    static void SetVoxelSize(const G4ThreeVector&);
+    /// Accumulate the voxels per track (default) or per event. Hits of
+    /// voxels accumulated per event have a track ID of -1.
+    static void SetVoxelPerTrack(G4bool);
+
   private:
     ///
     virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
+    /// Add the energy deposit to the hit of its voxel
+    void AddToVoxel(G4int track_id, const G4ThreeVector& pos,
+                    G4double time, G4double edep, G4double weight);
+
   private:
+    /// Track ID (or -1) and indices of a voxel
+    struct VoxelKey {
+      G4int track_id, i, j, k;
+      bool operator==(const VoxelKey& other) const
+      { return track_id == other.track_id &&
+          i == other.i && j == other.j && k == other.k; }
+    };
+
+    struct VoxelKeyHash {
+      size_t operator()(const VoxelKey& key) const
+      { return ((size_t(key.track_id) * 73856093) ^ (size_t(key.i) * 19349663) ^
+                (size_t(key.j) * 83492791) ^ (size_t(key.k) * 2654435761u)); }
+    };
+
     IonizationHitsCollection* IHC_;
     G4String det_name_;
     G4bool include_;
+
+    /// Hits of the voxels of the current event
+    std::unordered_map<VoxelKey, IonizationHit*, VoxelKeyHash> voxels_;
+
+    static G4ThreeVector voxel_size_;
+    static G4bool voxel_per_track_;
   };
 
   inline void IonizationSD::IncludeInTotalEnergyDeposit(G4bool inc)
   { include_ = inc; }
 
+  inline void IonizationSD::SetVoxelSize(const G4ThreeVector& size)
+  { voxel_size_ = size; }
+
+  inline void IonizationSD::SetVoxelPerTrack(G4bool per_track)
+  { voxel_per_track_ = per_track; }
+
 } // end namespace nexus
 
 #endif
@@ -8,6 +8,7 @@
 // ----------------------------------------------------------------------------
 
 #include "SensorSD.h"
+#include "EventStats.h"
 
 #include <G4OpticalPhoton.hh>
 #include <G4SDManager.hh>
@@ -88,6 +89,8 @@ namespace nexus {
     G4double time = step->GetPostStepPoint()->GetGlobalTime();
     hit->Fill(time);
 
+    EventStats::AddDetectedPhotons(1);
+
     return true;
   }
 
@@ -0,0 +1,135 @@
+#include <Decay0File.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <catch.hpp>
+
+
+namespace {
+
+  const std::string genbb_text =
+    " GENBB generated file: test.genbb\n"
+    " Time - in sec, momentum - in MeV/c\n"
+    " First event and full number of events:\n"
+    "           1           3\n"
+    "\n"
+    "       0  3214.71       2\n"
+    "  3 -0.135950       1.11337      0.703691      0.00000\n"
+    "  1 -0.199920      0.659025      0.630931      0.00000\n"
+    "       1  491.558       1\n"
+    " 47  -122.832      -173.009       111.106     0.873729E-03\n"
+    "       2  100.082       3\n"
+    "  3  0.332183      0.500002     -0.503284E-01  0.00000\n"
+    "  2  0.1             0.2           0.3          0.00000\n"
+    "  1  0.4             0.5           0.6          0.00000\n";
+
+  std::string TempPath(const std::string& name)
+  {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+}
+
+
+TEST_CASE("Decay0File") {
+
+  // This tests checks that a .genbb file converted to the binary format
+  // is read back event by event, and that SkipTo reaches any event.
+
+  std::string genbb  = TempPath("nexus_decay0_test.genbb");
+  std::string binary = TempPath("nexus_decay0_test.bin");
+  std::ofstream(genbb) << genbb_text;
+
+  REQUIRE(nexus::Decay0File::Convert(genbb, binary) == 3);
+  std::remove(genbb.c_str());
+  REQUIRE(nexus::Decay0File::IsBinary(binary));
+
+  nexus::Decay0File file;
+  REQUIRE(file.Open(binary));
+  REQUIRE(file.GetNumberOfEvents() == 3);
+  REQUIRE(file.GetHeader().find("First event") != std::string::npos);
+
+  const nexus::Decay0EventRecord* evt = file.ReadEvent();
+  REQUIRE(evt != nullptr);
+  REQUIRE(evt->entries == 2);
+  REQUIRE(evt->time == Approx(3214.71));
+  const nexus::Decay0ParticleRecord* parts = file.GetParticles(evt);
+  REQUIRE(parts[0].pdg == 11);
+  REQUIRE(parts[0].py == Approx(1.11337));
+  REQUIRE(parts[1].pdg == 22);
+
+  file.SkipTo(2);
+  REQUIRE(file.GetNextEvent() == 2);
+  evt = file.ReadEvent();
+  REQUIRE(evt->number == 2);
+  REQUIRE(evt->entries == 3);
+  parts = file.GetParticles(evt);
+  REQUIRE(parts[1].pdg == -11);
+  REQUIRE(parts[2].pz == Approx(0.6));
+  REQUIRE(file.ReadEvent() == nullptr);
+
+  file.SkipTo(1);
+  evt = file.ReadEvent();
+  REQUIRE(evt->number == 1);
+  REQUIRE(file.GetParticles(evt)->pdg == 1000020040);
+
+  file.Close();
+  std::remove(binary.c_str());
+}
+
+
+TEST_CASE("Decay0File invalid files") {
+
+  // This tests checks that binary files whose events point
+  // beyond their particles or that are truncated are rejected.
+
+  std::string genbb  = TempPath("nexus_decay0_invalid.genbb");
+  std::string binary = TempPath("nexus_decay0_invalid.bin");
+  std::ofstream(genbb) << genbb_text;
+  nexus::Decay0File::Convert(genbb, binary);
+  std::remove(genbb.c_str());
+
+  std::string bytes;
+  {
+    std::ifstream in(binary, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  auto rewrite = [&](const std::string& contents) {
+    std::ofstream out(binary, std::ios::binary);
+    out.write(contents.data(), contents.size());
+  };
+
+  nexus::Decay0File file;
+
+  // Too many particles in the last event
+  uint64_t events_offset;
+  std::memcpy(&events_offset, bytes.data() + 32, sizeof(events_offset));
+  std::string corrupt = bytes;
+  const uint32_t entries = 4;
+  std::memcpy(&corrupt[events_offset + 2 * sizeof(nexus::Decay0EventRecord) + 24],
+              &entries, sizeof(entries));
+  rewrite(corrupt);
+  REQUIRE(!file.Open(binary));
+
+  // Text header overlapping the events
+  corrupt = bytes;
+  const uint64_t header_size = events_offset;
+  std::memcpy(&corrupt[24], &header_size, sizeof(header_size));
+  rewrite(corrupt);
+  REQUIRE(!file.Open(binary));
+
+  rewrite(bytes.substr(0, bytes.size() - 1));
+  REQUIRE(!file.Open(binary));
+
+  rewrite(bytes);
+  REQUIRE(file.Open(binary));
+
+  file.Close();
+  std::remove(binary.c_str());
+}
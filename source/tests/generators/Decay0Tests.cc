@@ -0,0 +1,68 @@
+#include <decay0.h>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <catch.hpp>
+
+
+// Two-sample Kolmogorov-Smirnov statistic
+double KSDistance(std::vector<double> a, std::vector<double> b)
+{
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  size_t i = 0, j = 0;
+  double d = 0.;
+  while (i < a.size() && j < b.size()) {
+    if (a[i] < b[j]) i++;
+    else             j++;
+    d = std::max(d, std::abs(double(i)/a.size() - double(j)/b.size()));
+  }
+  return d;
+}
+
+
+TEST_CASE("decay0 tabulated 2nubb sampling") {
+
+  // This test checks that the energies of the two electrons of a
+  // Xe-136 2nubb decay sampled from the tabulated joint spectrum
+  // follow the same distribution as those sampled by rejection.
+  // The energy window is restricted to keep the rejection sampler fast.
+
+  G4Random::setTheSeed(1234);
+
+  const double emin = 2.0;
+  decay0 generator("Xe136", 0, 4, emin);
+  REQUIRE(generator.IsTabulated());
+
+  const int n = 4000;
+  std::vector<decay0Part> parts;
+  std::vector<double> esum_table, e1_table, esum_rej, e1_rej;
+
+  for (int i=0; i<n; i++) {
+    generator.decay0DoIt(parts);
+    REQUIRE(parts.size() == 2);
+    const double esum = parts[0].energy_ + parts[1].energy_;
+    REQUIRE(esum >= emin);
+    REQUIRE(esum <= 2.45783);
+    esum_table.push_back(esum);
+    e1_table.push_back(parts[0].energy_);
+  }
+
+  generator.SetTabulatedSampling(false);
+  REQUIRE(!generator.IsTabulated());
+
+  for (int i=0; i<n; i++) {
+    generator.decay0DoIt(parts);
+    esum_rej.push_back(parts[0].energy_ + parts[1].energy_);
+    e1_rej.push_back(parts[0].energy_);
+  }
+
+  // Critical value of the KS test at 1% significance
+  const double d_crit = 1.63 * std::sqrt(2./n);
+  REQUIRE(KSDistance(esum_table, esum_rej) < d_crit);
+  REQUIRE(KSDistance(e1_table,   e1_rej)   < d_crit);
+
+}
@@ -0,0 +1,38 @@
+#include <SparseWaveform.h>
+
+#include <vector>
+
+#include <catch.hpp>
+
+TEST_CASE("Sparse waveform round trip") {
+
+  // This tests checks that decoding an encoded waveform gives back
+  // the same bins and charges, including large values.
+
+  std::vector<std::pair<unsigned int, unsigned int>> bins =
+    {{120, 1}, {121, 3}, {122, 2}, {130, 40000}, {70000, 1}, {70001, 5}};
+
+  std::vector<uint16_t> values;
+  nexus::EncodeWaveform(bins, values);
+
+  auto decoded = nexus::DecodeWaveform(bins.front().first,
+                                       values.data(), values.size());
+  REQUIRE(decoded == bins);
+}
+
+
+TEST_CASE("Sparse waveform size") {
+
+  // This tests checks that a pulse of consecutive bins takes
+  // one value per bin plus the gap and the length of the run.
+
+  std::vector<std::pair<unsigned int, unsigned int>> bins;
+  for (unsigned int b=1000; b<1100; ++b) bins.push_back({b, b % 7});
+
+  std::vector<uint16_t> values;
+  nexus::EncodeWaveform(bins, values);
+
+  REQUIRE(values.size() == bins.size() + 2);
+  REQUIRE(values[0] == 0);
+  REQUIRE(values[1] == bins.size());
+}
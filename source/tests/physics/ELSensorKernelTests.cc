@@ -0,0 +1,148 @@
+#include <ELSensorKernel.h>
+
+#include <G4StateManager.hh>
+#include <G4VExceptionHandler.hh>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+
+namespace {
+
+  // Turn the fatal exceptions of Geant4 into C++ exceptions
+  class ThrowingHandler: public G4VExceptionHandler
+  {
+  public:
+    G4bool Notify(const char*, const char*, G4ExceptionSeverity severity, const char* description)
+    {
+      if (severity == FatalException) throw std::runtime_error(description);
+      return false;
+    }
+  };
+
+  template <typename T>
+  void Append(std::string& bytes, T value)
+  {
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  // Kernel with a grid of 2x2 nodes (10 mm apart, starting at -5 mm)
+  // and two sensors of a single sensitive detector. Node 0 sees both
+  // sensors, node 3 sees sensor 1 and the other nodes see none.
+  std::string Kernel(const std::vector<uint32_t>& offsets = {0, 2, 2, 2, 3})
+  {
+    std::string bytes("NELK");
+    Append<uint32_t>(bytes, 1);           // version
+    Append<uint32_t>(bytes, 1);           // sensitive detectors
+    Append<uint32_t>(bytes, 2);           // sensors
+    Append<uint32_t>(bytes, 2);           // nx
+    Append<uint32_t>(bytes, 2);           // ny
+    for (double v: {-5., -5., 10., 10.}) // min_x, min_y, step_x, step_y
+      Append(bytes, v);
+
+    Append<uint32_t>(bytes, 4);
+    bytes.append("SiPM");
+
+    for (int32_t id: {1000, 1001}) {
+      Append(bytes, id);
+      Append<uint32_t>(bytes, 0);
+      for (float v: {0.f, 0.f, 10.f}) Append(bytes, v);
+    }
+
+    for (uint32_t offset: offsets) Append(bytes, offset);
+
+    const std::vector<std::pair<uint32_t, float>> entries = {{0, 0.25f}, {1, 0.5f}, {1, 0.125f}};
+    for (const auto& e: entries) {
+      Append(bytes, e.first);
+      Append(bytes, e.second);
+    }
+    return bytes;
+  }
+
+  std::string Write(const std::string& bytes)
+  {
+    namespace fs = std::filesystem;
+    std::string filename = (fs::temp_directory_path() / "nexus_el_kernel_test.bin").string();
+    std::ofstream out(filename, std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+    return filename;
+  }
+
+}
+
+TEST_CASE("ELSensorKernel") {
+
+  // This tests checks that a kernel file is read back, that the
+  // entries of the nearest node are returned and that points outside
+  // the grid have none.
+
+  std::string filename = Write(Kernel());
+  nexus::ELSensorKernel kernel(filename);
+  std::remove(filename.c_str());
+
+  REQUIRE(kernel.GetNumberOfSensitiveDetectors() == 1);
+  REQUIRE(kernel.GetSensitiveDetectorName(0) == "SiPM");
+  REQUIRE(kernel.GetNumberOfSensors() == 2);
+  REQUIRE(kernel.GetSensor(1).id == 1001);
+  REQUIRE(kernel.GetSensor(1).position.z() == Approx(10.));
+
+  size_t n;
+  // Nearest node is node 0 (-5, -5)
+  const nexus::ELSensorKernel::Entry* entries = kernel.Lookup(-1., -9., n);
+  REQUIRE(entries != nullptr);
+  REQUIRE(n == 2);
+  REQUIRE(entries[0].sensor == 0);
+  REQUIRE(entries[0].probability == Approx(0.25));
+  REQUIRE(entries[1].sensor == 1);
+  REQUIRE(entries[1].probability == Approx(0.5));
+
+  // Node 1 (5, -5) has no entries
+  kernel.Lookup(4., -6., n);
+  REQUIRE(n == 0);
+
+  // Node 3 (5, 5)
+  entries = kernel.Lookup(9.9, 0.1, n);
+  REQUIRE(n == 1);
+  REQUIRE(entries[0].sensor == 1);
+  REQUIRE(entries[0].probability == Approx(0.125));
+
+  // Beyond half a step from the grid
+  REQUIRE(kernel.Lookup(-10.1, 0., n) == nullptr);
+  REQUIRE(n == 0);
+  REQUIRE(kernel.Lookup(0., 10.1, n) == nullptr);
+}
+
+TEST_CASE("ELSensorKernel invalid files") {
+
+  // This tests checks that truncated kernels and kernels with
+  // unsorted or too large offsets are rejected.
+
+  // The handler registers itself, and the previous one is restored
+  // when the test ends, whatever its result
+  struct Restore {
+    G4VExceptionHandler* handler;
+    ~Restore() { G4StateManager::GetStateManager()->SetExceptionHandler(handler); }
+  };
+  Restore restore{G4StateManager::GetStateManager()->GetExceptionHandler()};
+  ThrowingHandler handler;
+
+  std::string kernel = Kernel();
+  for (size_t size: {size_t(10), size_t(60), kernel.size() - 1}) {
+    std::string filename = Write(kernel.substr(0, size));
+    REQUIRE_THROWS(nexus::ELSensorKernel(filename));
+    std::remove(filename.c_str());
+  }
+
+  std::string filename = Write(Kernel({0, 2, 1, 2, 3}));
+  REQUIRE_THROWS_WITH(nexus::ELSensorKernel(filename), "Kernel offsets are not sorted.");
+  std::remove(filename.c_str());
+
+  filename = Write(Kernel({0, 2, 2, 2, 4000000000u}));
+  REQUIRE_THROWS(nexus::ELSensorKernel(filename));
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,125 @@
+#include <FieldMapDriftField.h>
+
+#include <G4LorentzVector.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#include <catch.hpp>
+
+namespace {
+
+  // Value of the map at node (i, j, k). It is not linear in the node
+  // indices, so that the interpolation is not exact by accident.
+  float NodeValue(size_t v, size_t i, size_t j, size_t k)
+  {
+    return 1. + v + 2.*i + 3.*j*j + 5.*k + 7.*i*j*k;
+  }
+
+}
+
+TEST_CASE("FieldMapDriftField") {
+
+  // This tests checks that a map written by FieldMapDriftField::Write is
+  // read back, and that its values are interpolated trilinearly at the
+  // nodes, along the edges and at the centre of the cells.
+
+  namespace fs = std::filesystem;
+  std::string filename = (fs::temp_directory_path() / "nexus_drift_map_test.bin").string();
+
+  const size_t   n[3]    = {3, 2, 2};
+  const G4double min[3]  = {-10.*mm, 0.*mm, 100.*mm};
+  const G4double step[3] = {10.*mm, 5.*mm, 20.*mm};
+  const size_t nv = nexus::FieldMapDriftField::kNValues;
+
+  std::vector<float> records;
+  for (size_t k=0; k<n[2]; ++k)
+    for (size_t j=0; j<n[1]; ++j)
+      for (size_t i=0; i<n[0]; ++i)
+        for (size_t v=0; v<nv; ++v)
+          // No diffusion, so that drifting is deterministic
+          records.push_back(v >= 5 ? 0. : NodeValue(v, i, j, k));
+
+  nexus::FieldMapDriftField::Write(filename, n, min, step, records);
+  nexus::FieldMapDriftField field(filename);
+
+  // Drift a point at fractional node coordinates (u, v, w)
+  // and compare with the expected drift line parameters
+  auto check = [&](G4double u, G4double v, G4double w, const std::vector<G4double>& expected) {
+    G4LorentzVector xyzt(min[0] + u*step[0], min[1] + v*step[1], min[2] + w*step[2], 1.*microsecond);
+    G4double length = field.Drift(xyzt);
+    REQUIRE(xyzt.x() == Approx(expected[0] * mm));
+    REQUIRE(xyzt.y() == Approx(expected[1] * mm));
+    REQUIRE(xyzt.z() == Approx(expected[2] * mm));
+    REQUIRE(xyzt.t() == Approx(1.*microsecond + expected[3] * microsecond));
+    REQUIRE(length   == Approx(expected[4] * mm));
+  };
+
+  auto node = [&](size_t i, size_t j, size_t k) {
+    std::vector<G4double> values;
+    for (size_t v=0; v<nv; ++v) values.push_back(NodeValue(v, i, j, k));
+    return values;
+  };
+
+  auto average = [&](const std::vector<std::vector<G4double>>& nodes) {
+    std::vector<G4double> values(nv, 0.);
+    for (const auto& nd: nodes)
+      for (size_t v=0; v<nv; ++v) values[v] += nd[v] / nodes.size();
+    return values;
+  };
+
+  // Corners of the map and an inner node
+  check(0., 0., 0., node(0, 0, 0));
+  check(2., 1., 1., node(2, 1, 1));
+  check(2., 0., 1., node(2, 0, 1));
+  check(1., 1., 0., node(1, 1, 0));
+
+  // Middle of the edges of a cell
+  check(0.5, 0., 0., average({node(0, 0, 0), node(1, 0, 0)}));
+  check(2.,  0.5, 1., average({node(2, 0, 1), node(2, 1, 1)}));
+  check(1.,  1., 0.5, average({node(1, 1, 0), node(1, 1, 1)}));
+
+  // Centre of both cells
+  check(0.5, 0.5, 0.5, average({node(0, 0, 0), node(1, 0, 0), node(0, 1, 0), node(1, 1, 0),
+                                node(0, 0, 1), node(1, 0, 1), node(0, 1, 1), node(1, 1, 1)}));
+  check(1.5, 0.5, 0.5, average({node(1, 0, 0), node(2, 0, 0), node(1, 1, 0), node(2, 1, 0),
+                                node(1, 0, 1), node(2, 0, 1), node(1, 1, 1), node(2, 1, 1)}));
+
+  // Points outside the map are lost
+  G4LorentzVector outside(min[0] - 1.*mm, min[1], min[2], 0.);
+  REQUIRE(field.Drift(outside) == 0.);
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("FieldMapDriftField lost lines") {
+
+  // This tests checks that the cells touching a drift line that
+  // does not reach the anode (negative drift time) lose the electron.
+
+  namespace fs = std::filesystem;
+  std::string filename = (fs::temp_directory_path() / "nexus_drift_map_lost_test.bin").string();
+
+  const size_t   n[3]    = {3, 2, 2};
+  const G4double min[3]  = {0., 0., 0.};
+  const G4double step[3] = {1.*mm, 1.*mm, 1.*mm};
+  const size_t nv = nexus::FieldMapDriftField::kNValues;
+
+  std::vector<float> records(n[0] * n[1] * n[2] * nv, 0.);
+  for (size_t r=0; r<n[0]*n[1]*n[2]; ++r) records[r*nv + 3] = 1.;
+  // Node (2, 0, 0) is the end of a lost line
+  records[2*nv + 3] = -1.;
+
+  nexus::FieldMapDriftField::Write(filename, n, min, step, records);
+  nexus::FieldMapDriftField field(filename);
+
+  G4LorentzVector lost(1.5*mm, 0.5*mm, 0.5*mm, 0.);
+  REQUIRE(field.Drift(lost) == 0.);
+
+  G4LorentzVector kept(0.5*mm, 0.5*mm, 0.5*mm, 0.);
+  REQUIRE(field.Drift(kept) > 0.);
+
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,35 @@
+#include <AliasTable.h>
+#include <Randomize.hh>
+
+#include <cmath>
+#include <vector>
+
+#include <catch.hpp>
+
+TEST_CASE("AliasTable") {
+
+  // This tests checks that the indices sampled from the alias table
+  // follow the input weights, including bins with zero weight.
+
+  std::vector<G4double> weights = {0., 3., 1., 0.5, 5.5, 0.};
+  nexus::AliasTable table(weights);
+
+  REQUIRE(table.GetSize() == weights.size());
+  REQUIRE(table.GetTotalWeight() == Approx(10.));
+
+  std::vector<G4int> counts(weights.size(), 0);
+  G4int n = 100000;
+  for (G4int i=0; i<n; i++) {
+    size_t idx = table.Sample();
+    REQUIRE(idx < weights.size());
+    counts[idx]++;
+  }
+
+  for (size_t i=0; i<weights.size(); i++) {
+    G4double p = weights[i] / 10.;
+    REQUIRE(table.GetProbability(i) == Approx(p));
+    // Five standard deviations
+    REQUIRE(std::abs(counts[i] - n*p) <= 5. * std::sqrt(n*p*(1.-p)) + 1.);
+  }
+
+}
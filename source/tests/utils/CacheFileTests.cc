@@ -0,0 +1,46 @@
+#include <CacheFile.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <catch.hpp>
+
+TEST_CASE("CacheFile") {
+
+  // This tests checks that a cache file is written with its header
+  // and contents, and that its header is validated when read back.
+
+  namespace fs = std::filesystem;
+  std::string filename = (fs::temp_directory_path() / "nexus_cache_test.bin").string();
+
+  std::vector<double> values = {1., 2., 3.};
+  uint32_t n = values.size();
+  REQUIRE(nexus::WriteCacheFile(filename, "TEST", 2,
+                                {{&n, sizeof(n)},
+                                 {values.data(), values.size()*sizeof(double)}}));
+
+  // No temporary file is left behind
+  REQUIRE(fs::exists(filename));
+  for (const auto& entry: fs::directory_iterator(fs::temp_directory_path()))
+    REQUIRE(entry.path().filename().string().rfind("nexus_cache_test.bin.tmp", 0) != 0);
+
+  std::ifstream in(filename, std::ios::binary);
+  nexus::CacheHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  uint64_t size = fs::file_size(filename);
+
+  REQUIRE(nexus::CheckCacheHeader(header, size, "TEST", 2));
+  REQUIRE_FALSE(nexus::CheckCacheHeader(header, size, "TEST", 1));
+  REQUIRE_FALSE(nexus::CheckCacheHeader(header, size, "BEST", 2));
+  REQUIRE_FALSE(nexus::CheckCacheHeader(header, size - 1, "TEST", 2));
+
+  uint32_t n_read;
+  std::vector<double> read(3);
+  in.read(reinterpret_cast<char*>(&n_read), sizeof(n_read));
+  in.read(reinterpret_cast<char*>(read.data()), read.size()*sizeof(double));
+  REQUIRE(n_read == n);
+  REQUIRE(read == values);
+
+  fs::remove(filename);
+}
@@ -0,0 +1,51 @@
+#include <LineEmitter.h>
+
+#include <G4Gamma.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <cmath>
+#include <vector>
+
+#include <catch.hpp>
+
+TEST_CASE("LineEmitter") {
+
+  // This tests checks that the lines are emitted with their probability
+  // per decay (including no emission) and with the right energy.
+
+  nexus::LineEmitter emitter;
+  G4ParticleDefinition* gamma = G4Gamma::Definition();
+  emitter.AddLine(gamma,  12.6*keV, 0.15);
+  emitter.AddLine(gamma,  14.1*keV, 0.05);
+  emitter.AddLine(gamma, 511.0*keV, 0.30, true);
+
+  REQUIRE(emitter.GetNumberOfLines() == 3);
+  REQUIRE(emitter.GetTotalProbability() == Approx(0.5));
+
+  std::vector<G4int> counts(4, 0);
+  G4int n = 100000;
+  for (G4int i=0; i<n; i++) {
+    G4int line = emitter.SampleLine();
+    REQUIRE(line >= -1);
+    REQUIRE(line < 3);
+    counts[line + 1]++;
+  }
+
+  std::vector<G4double> expected = {0.5, 0.15, 0.05, 0.30};
+  for (size_t i=0; i<expected.size(); i++) {
+    G4double p = expected[i];
+    REQUIRE(std::abs(counts[i] - n*p) <= 5. * std::sqrt(n*p*(1.-p)));
+  }
+
+  // Back-to-back lines add two particles with opposite momenta
+  G4PrimaryVertex vertex;
+  emitter.AddPrimaries(2, &vertex);
+  REQUIRE(vertex.GetNumberOfParticle() == 2);
+  G4ThreeVector p1 = vertex.GetPrimary(0)->GetMomentum();
+  G4ThreeVector p2 = vertex.GetPrimary(1)->GetMomentum();
+  REQUIRE(p1.mag() == Approx(511.0*keV));
+  REQUIRE((p1 + p2).mag() == Approx(0.).margin(1.e-9));
+
+}
@@ -0,0 +1,84 @@
+#include <PhiloxEngine.h>
+
+#include <sstream>
+#include <vector>
+
+#include <catch.hpp>
+
+TEST_CASE("Philox known answers") {
+
+  // This tests checks the Philox4x32-10 blocks against the
+  // known-answer values of the Random123 reference implementation.
+
+  uint32_t key1[2] = {0, 0};
+  uint32_t ctr1[4] = {0, 0, 0, 0};
+  nexus::PhiloxEngine::Philox(key1, ctr1);
+  REQUIRE(ctr1[0] == 0x6627e8d5);
+  REQUIRE(ctr1[1] == 0xe169c58d);
+  REQUIRE(ctr1[2] == 0xbc57ac4c);
+  REQUIRE(ctr1[3] == 0x9b00dbd8);
+
+  uint32_t key2[2] = {0xa4093822, 0x299f31d0};
+  uint32_t ctr2[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  nexus::PhiloxEngine::Philox(key2, ctr2);
+  REQUIRE(ctr2[0] == 0xd16cfe09);
+  REQUIRE(ctr2[1] == 0x94fdcceb);
+  REQUIRE(ctr2[2] == 0x5001e420);
+  REQUIRE(ctr2[3] == 0x24126ea1);
+}
+
+
+TEST_CASE("Philox event streams") {
+
+  // This tests checks that the random numbers of an event only
+  // depend on the seed and the event number.
+
+  nexus::PhiloxEngine engine(12345);
+
+  engine.SetEvent(41);
+  std::vector<double> first;
+  for (int i=0; i<100; ++i) first.push_back(engine.flat());
+
+  // Consume numbers of other events in between
+  engine.SetEvent(3);
+  for (int i=0; i<1000; ++i) engine.flat();
+
+  engine.SetEvent(41);
+  for (int i=0; i<100; ++i) {
+    REQUIRE(engine.flat() == first[i]);
+  }
+
+  // Another event gives another stream
+  engine.SetEvent(42);
+  REQUIRE(engine.flat() != first[0]);
+
+  // And so does another seed
+  engine.setSeed(54321, 0);
+  engine.SetEvent(41);
+  REQUIRE(engine.flat() != first[0]);
+}
+
+
+TEST_CASE("Philox status") {
+
+  // This tests checks that the state of the engine
+  // can be saved and restored in the middle of a block.
+
+  nexus::PhiloxEngine engine(7);
+  engine.SetEvent(10);
+  engine.flat();
+  engine.flat();
+  engine.flat();
+
+  std::stringstream status;
+  engine.put(status);
+  std::vector<double> expected;
+  for (int i=0; i<10; ++i) expected.push_back(engine.flat());
+
+  nexus::PhiloxEngine other(8);
+  other.get(status);
+  REQUIRE(status.good());
+  for (int i=0; i<10; ++i) {
+    REQUIRE(other.flat() == expected[i]);
+  }
+}
@@ -0,0 +1,41 @@
+#include <PrimaryVertexUtils.h>
+
+#include <G4Event.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4VPrimaryGenerator.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+namespace {
+
+  // Generator adding two vertices at t=0 and t=1 ns
+  class TwoVertexGenerator: public G4VPrimaryGenerator
+  {
+  public:
+    void GeneratePrimaryVertex(G4Event* event)
+    {
+      event->AddPrimaryVertex(new G4PrimaryVertex(G4ThreeVector(), 0.));
+      event->AddPrimaryVertex(new G4PrimaryVertex(G4ThreeVector(), 1.*ns));
+    }
+  };
+
+}
+
+TEST_CASE("GenerateDelayedVertices") {
+
+  // This tests checks that only the vertices added by the generator
+  // are delayed, and by the requested time.
+
+  TwoVertexGenerator generator;
+  G4Event event;
+
+  nexus::GenerateDelayedVertices(generator, &event, 0.);
+  nexus::GenerateDelayedVertices(generator, &event, 5.*ms);
+
+  REQUIRE(event.GetNumberOfPrimaryVertex() == 4);
+  REQUIRE(event.GetPrimaryVertex(0)->GetT0() == Approx(0.));
+  REQUIRE(event.GetPrimaryVertex(1)->GetT0() == Approx(1.*ns));
+  REQUIRE(event.GetPrimaryVertex(2)->GetT0() == Approx(5.*ms));
+  REQUIRE(event.GetPrimaryVertex(3)->GetT0() == Approx(5.*ms + 1.*ns));
+}
@@ -41,3 +41,38 @@ TEST_CASE("Direction Function") {
   }
 
 }
+
+
+TEST_CASE("Truncated Gaussian") {
+
+  // This tests checks that the truncated Gaussian stays within the
+  // interval and reproduces the mean of the truncated distribution,
+  // both in the bulk and far in the tail of the Gaussian.
+
+  G4double mean  = 1.;
+  G4double sigma = 2.;
+
+  for (auto lo : {0., 9.}) {
+    G4double hi = lo + 1.;
+
+    G4double sum = 0.;
+    G4int n = 20000;
+    for (G4int i=0; i<n; i++) {
+      G4double x = nexus::TruncatedGaussian(mean, sigma, lo, hi);
+      REQUIRE(x >= lo);
+      REQUIRE(x <= hi);
+      sum += x;
+    }
+
+    // Analytic mean of the truncated Gaussian
+    G4double a = (lo - mean) / sigma;
+    G4double b = (hi - mean) / sigma;
+    G4double pdf_a = std::exp(-a*a/2.) / std::sqrt(2.*CLHEP::pi);
+    G4double pdf_b = std::exp(-b*b/2.) / std::sqrt(2.*CLHEP::pi);
+    G4double prob  = nexus::GaussianProbabilityInRange(mean, sigma, lo, hi);
+    G4double expected = mean + sigma * (pdf_a - pdf_b) / prob;
+
+    REQUIRE(std::abs(sum/n - expected) < 0.01);
+  }
+
+}
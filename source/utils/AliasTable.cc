@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// nexus | AliasTable.cc
+//
+// Walker alias table to sample an index from a discrete distribution
+// in constant time.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "AliasTable.h"
+
+#include <G4Exception.hh>
+#include <Randomize.hh>
+
+
+namespace nexus {
+
+  AliasTable::AliasTable(): total_(0.)
+  {
+  }
+
+
+
+  AliasTable::AliasTable(const std::vector<G4double>& weights): total_(0.)
+  {
+    Build(weights.data(), weights.size());
+  }
+
+
+
+  AliasTable::AliasTable(const G4double* weights, size_t n): total_(0.)
+  {
+    Build(weights, n);
+  }
+
+
+
+  AliasTable::~AliasTable()
+  {
+  }
+
+
+
+  void AliasTable::Build(const G4double* weights, size_t n)
+  {
+    total_ = 0.;
+    for (size_t i=0; i<n; ++i) {
+      if (weights[i] < 0.)
+        G4Exception("[AliasTable]", "Build()", FatalException,
+                    "Negative weight in discrete distribution.");
+      total_ += weights[i];
+    }
+
+    if (n == 0 || total_ <= 0.)
+      G4Exception("[AliasTable]", "Build()", FatalException,
+                  "Discrete distribution is empty or has zero total weight.");
+
+    prob_.assign(n, 1.);
+    alias_.resize(n);
+    norm_.resize(n);
+
+    // Scale the weights so that their mean is 1 and split the bins
+    // into those below and above the mean
+    std::vector<G4double> scaled(n);
+    std::vector<size_t> small, large;
+    for (size_t i=0; i<n; ++i) {
+      norm_[i]   = weights[i] / total_;
+      scaled[i]  = norm_[i] * n;
+      alias_[i]  = i;
+      if (scaled[i] < 1.) small.push_back(i);
+      else                large.push_back(i);
+    }
+
+    // Fill each small bin up to 1 with probability taken from a large one
+    while (!small.empty() && !large.empty()) {
+      size_t s = small.back(); small.pop_back();
+      size_t l = large.back();
+      prob_[s]  = scaled[s];
+      alias_[s] = l;
+      scaled[l] = (scaled[l] + scaled[s]) - 1.;
+      if (scaled[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+
+    // Whatever is left is 1 up to rounding errors
+    for (size_t i: small) prob_[i] = 1.;
+    for (size_t i: large) prob_[i] = 1.;
+  }
+
+
+
+  size_t AliasTable::Sample() const
+  {
+    G4double u = G4UniformRand() * prob_.size();
+    size_t i = static_cast<size_t>(u);
+    if (i >= prob_.size()) i = prob_.size() - 1;
+    return (u - i < prob_[i]) ? i : alias_[i];
+  }
+
+} // namespace nexus
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+// nexus | AliasTable.h
+//
+// Walker alias table to sample an index from a discrete distribution
+// in constant time.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include <globals.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class AliasTable
+  {
+  public:
+    /// Default constructor: empty table
+    AliasTable();
+    /// Build the table from a list of (not necessarily normalized)
+    /// non-negative weights
+    AliasTable(const std::vector<G4double>& weights);
+    AliasTable(const G4double* weights, size_t n);
+    /// Destructor
+    ~AliasTable();
+
+    /// Build the table from a list of non-negative weights
+    void Build(const G4double* weights, size_t n);
+
+    /// Return a random index distributed according to the weights
+    size_t Sample() const;
+
+    /// Normalized probability of index i
+    G4double GetProbability(size_t i) const;
+
+    /// Sum of the weights the table was built from
+    G4double GetTotalWeight() const;
+
+    size_t GetSize() const;
+
+  private:
+    std::vector<G4double> prob_;  ///< Probability of keeping the bin
+    std::vector<size_t>   alias_; ///< Alternative bin
+    std::vector<G4double> norm_;  ///< Normalized input weights
+    G4double total_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4double AliasTable::GetProbability(size_t i) const { return norm_[i]; }
+  inline G4double AliasTable::GetTotalWeight() const { return total_; }
+  inline size_t AliasTable::GetSize() const { return prob_.size(); }
+
+} // namespace nexus
+
+#endif
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------
+// nexus | CacheFile.cc
+//
+// Functions to write and validate the cache files (and directories) that
+// nexus jobs share.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "CacheFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+
+namespace nexus {
+
+  G4bool WriteAtomically(const std::string& path,
+                         const std::function<G4bool(const std::string&)>& writer)
+  {
+    namespace fs = std::filesystem;
+
+    std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+    std::error_code ec;
+
+    if (!writer(tmp_path)) {
+      fs::remove_all(tmp_path, ec);
+      return false;
+    }
+
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+      // A directory cannot replace the one another job may have
+      // created in the meantime
+      fs::remove_all(tmp_path, ec);
+      return fs::exists(path, ec);
+    }
+
+    return true;
+  }
+
+
+  G4bool WriteCacheFile(const std::string& filename, const char* magic,
+                        uint32_t version, const std::vector<CacheBlock>& blocks)
+  {
+    CacheHeader header;
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.size = 0;
+    for (const auto& block: blocks) header.size += block.size;
+
+    return WriteAtomically(filename, [&](const std::string& tmp_name) {
+      std::ofstream out(tmp_name, std::ios::binary);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (const auto& block: blocks)
+        out.write(static_cast<const char*>(block.data), block.size);
+      out.close();
+      return G4bool(out);
+    });
+  }
+
+
+  G4bool CheckCacheHeader(const CacheHeader& header, uint64_t file_size,
+                          const char* magic, uint32_t version)
+  {
+    return std::memcmp(header.magic, magic, sizeof(header.magic)) == 0 &&
+           header.version == version &&
+           sizeof(CacheHeader) + header.size == file_size;
+  }
+
+} // namespace nexus
@@ -0,0 +1,57 @@
+// ----------------------------------------------------------------------------
+// nexus | CacheFile.h
+//
+// Functions to write and validate the cache files (and directories) that
+// nexus jobs share: an entry is written under a temporary name and then
+// renamed, so that concurrent jobs never read a partially written one,
+// and cache files start with a header identifying their kind and format.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef CACHE_FILE_H
+#define CACHE_FILE_H
+
+#include <globals.hh>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace nexus {
+
+  /// Header at the beginning of a cache file
+  struct CacheHeader {
+    char     magic[4]; ///< Kind of cache
+    uint32_t version;  ///< Version of its format
+    uint64_t size;     ///< Size in bytes of the contents after the header
+  };
+
+  /// Block of contents of a cache file
+  struct CacheBlock {
+    const void* data;
+    size_t size;
+  };
+
+  /// Create a cache entry (file or directory) at path. The writer fills
+  /// a temporary path, which is then renamed to path. Returns whether
+  /// the entry exists afterwards, which is also the case if another job
+  /// created it in the meantime.
+  G4bool WriteAtomically(const std::string& path,
+                         const std::function<G4bool(const std::string&)>& writer);
+
+  /// Write atomically a cache file with a header of the given kind
+  /// (four characters) and version followed by the blocks
+  G4bool WriteCacheFile(const std::string& filename, const char* magic,
+                        uint32_t version, const std::vector<CacheBlock>& blocks);
+
+  /// Check the header of a cache file of file_size bytes against
+  /// the expected kind and version
+  G4bool CheckCacheHeader(const CacheHeader& header, uint64_t file_size,
+                          const char* magic, uint32_t version);
+
+} // namespace nexus
+
+#endif
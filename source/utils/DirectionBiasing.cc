@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------------
+// nexus | DirectionBiasing.cc
+//
+// Importance sampling of the direction of primary particles towards a
+// target volume. A fraction of the directions is drawn uniformly within
+// the cone that the bounding sphere of the target subtends from the
+// vertex, the rest isotropically. The weight returned with each
+// direction (isotropic over biased probability density) keeps the
+// rates correct.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "DirectionBiasing.h"
+
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VSolid.hh>
+#include <G4AffineTransform.hh>
+#include <G4RandomDirection.hh>
+#include <G4Exception.hh>
+#include <Randomize.hh>
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+
+namespace {
+
+  // Depth-first search of a physical volume by name. On success,
+  // transform holds the placement of the volume in the world frame.
+  G4VPhysicalVolume* FindVolume(G4VPhysicalVolume* pv, const G4String& name,
+                                G4AffineTransform& transform)
+  {
+    G4AffineTransform local(pv->GetRotation(), pv->GetTranslation());
+    G4AffineTransform global = local * transform;
+
+    if (pv->GetName() == name) {
+      transform = global;
+      return pv;
+    }
+
+    G4LogicalVolume* lv = pv->GetLogicalVolume();
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+      G4AffineTransform t = global;
+      G4VPhysicalVolume* found = FindVolume(lv->GetDaughter(i), name, t);
+      if (found) {
+        transform = t;
+        return found;
+      }
+    }
+    return nullptr;
+  }
+
+}
+
+
+namespace nexus {
+
+  using namespace CLHEP;
+
+
+  DirectionBiasing::DirectionBiasing():
+    target_name_(""), fraction_(0.9), initialized_(false), radius_(0.)
+  {
+  }
+
+
+
+  DirectionBiasing::~DirectionBiasing()
+  {
+  }
+
+
+
+  void DirectionBiasing::SetTargetVolume(const G4String& name)
+  {
+    target_name_ = name;
+    initialized_ = false;
+  }
+
+
+
+  void DirectionBiasing::SetFraction(G4double fraction)
+  {
+    if (fraction < 0. || fraction >= 1.)
+      G4Exception("[DirectionBiasing]", "SetFraction()", FatalException,
+                  "The biased fraction must be in [0, 1), so that "
+                  "every direction can still be generated.");
+    fraction_ = fraction;
+  }
+
+
+
+  void DirectionBiasing::Initialize()
+  {
+    G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->
+      GetNavigatorForTracking()->GetWorldVolume();
+
+    G4AffineTransform transform;
+    G4VPhysicalVolume* target = world ? FindVolume(world, target_name_, transform) : nullptr;
+    if (!target) {
+      G4String msg = "Volume " + target_name_ + " not found in the geometry.";
+      G4Exception("[DirectionBiasing]", "Initialize()", FatalException, msg);
+    }
+
+    G4ThreeVector pmin, pmax;
+    target->GetLogicalVolume()->GetSolid()->BoundingLimits(pmin, pmax);
+    centre_ = transform.TransformPoint((pmin + pmax)/2.);
+    radius_ = (pmax - pmin).mag()/2.;
+
+    initialized_ = true;
+  }
+
+
+
+  G4double DirectionBiasing::Density(const G4ThreeVector& dir, const G4ThreeVector& axis,
+                                     G4double cos_max) const
+  {
+    G4double density = (1. - fraction_) / (4.*pi);
+    if (dir.dot(axis) >= cos_max)
+      density += fraction_ / (2.*pi * (1. - cos_max));
+    return density;
+  }
+
+
+
+  G4ThreeVector DirectionBiasing::Sample(const G4ThreeVector& vtx, G4double& weight,
+                                         G4bool symmetric)
+  {
+    weight = 1.;
+    if (!IsActive()) return G4RandomDirection();
+    if (!initialized_) Initialize();
+
+    // No biasing from within the bounding sphere of the target
+    G4ThreeVector axis = centre_ - vtx;
+    G4double dist = axis.mag();
+    if (dist <= radius_) return G4RandomDirection();
+    axis /= dist;
+
+    G4double cos_max = std::sqrt(1. - (radius_*radius_)/(dist*dist));
+
+    G4ThreeVector dir;
+    if (G4UniformRand() < fraction_) {
+      // Uniform direction within the cone around the axis
+      G4double cos_theta = 1. - G4UniformRand() * (1. - cos_max);
+      G4double sin_theta = std::sqrt(1. - cos_theta*cos_theta);
+      G4double phi = twopi * G4UniformRand();
+      dir = G4ThreeVector(sin_theta*std::cos(phi), sin_theta*std::sin(phi), cos_theta);
+      dir.rotateUz(axis);
+    }
+    else {
+      dir = G4RandomDirection();
+    }
+
+    G4double density = Density(dir, axis, cos_max);
+    if (symmetric) {
+      if (G4UniformRand() < 0.5) dir = -dir;
+      density = 0.5 * (density + Density(-dir, axis, cos_max));
+    }
+
+    weight = 1. / (4.*pi * density);
+    return dir;
+  }
+
+} // namespace nexus
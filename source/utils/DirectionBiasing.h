@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------------
+// nexus | DirectionBiasing.h
+//
+// Importance sampling of the direction of primary particles towards a
+// target volume. A fraction of the directions is drawn uniformly within
+// the cone that the bounding sphere of the target subtends from the
+// vertex, the rest isotropically. The weight returned with each
+// direction (isotropic over biased probability density) keeps the
+// rates correct.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef DIRECTION_BIASING_H
+#define DIRECTION_BIASING_H
+
+#include <G4ThreeVector.hh>
+
+
+namespace nexus {
+
+  class DirectionBiasing
+  {
+  public:
+    /// Constructor
+    DirectionBiasing();
+    /// Destructor
+    ~DirectionBiasing();
+
+    /// Name of the physical volume the directions are biased to.
+    /// An empty name switches the biasing off.
+    void SetTargetVolume(const G4String& name);
+    /// Fraction of the directions drawn towards the target
+    void SetFraction(G4double fraction);
+
+    G4bool IsActive() const;
+
+    /// Return a direction for a particle generated at vtx and its
+    /// statistical weight. For symmetric directions (e.g. pairs of
+    /// back-to-back particles), both the direction and its opposite
+    /// are favoured.
+    G4ThreeVector Sample(const G4ThreeVector& vtx, G4double& weight,
+                         G4bool symmetric=false);
+
+  private:
+    /// Locate the target in the geometry and compute its bounding sphere
+    void Initialize();
+    /// Probability density of the biased distribution for direction dir
+    G4double Density(const G4ThreeVector& dir, const G4ThreeVector& axis,
+                     G4double cos_max) const;
+
+  private:
+    G4String target_name_;
+    G4double fraction_;
+
+    G4bool initialized_;
+    G4ThreeVector centre_; ///< Centre of the bounding sphere of the target
+    G4double radius_;      ///< Radius of the bounding sphere of the target
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool DirectionBiasing::IsActive() const { return target_name_ != ""; }
+
+} // namespace nexus
+
+#endif
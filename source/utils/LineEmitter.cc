@@ -0,0 +1,120 @@
+// ----------------------------------------------------------------------------
+// nexus | LineEmitter.cc
+//
+// Tabulated set of mutually exclusive emission lines (particle, kinetic
+// energy and probability per decay). At most one line is emitted per
+// decay, chosen in constant time with an alias table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "LineEmitter.h"
+#include "DirectionBiasing.h"
+
+#include <G4ParticleDefinition.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4RandomDirection.hh>
+#include <G4Exception.hh>
+
+#include <algorithm>
+
+
+namespace nexus {
+
+  LineEmitter::LineEmitter(): built_(false)
+  {
+  }
+
+
+
+  LineEmitter::~LineEmitter()
+  {
+  }
+
+
+
+  void LineEmitter::AddLine(G4ParticleDefinition* particle, G4double energy,
+                            G4double probability, G4bool back_to_back)
+  {
+    if (!particle || energy < 0. || probability < 0.)
+      G4Exception("[LineEmitter]", "AddLine()", FatalException,
+                  "Invalid emission line.");
+
+    particles_.push_back(particle);
+    energies_.push_back(energy);
+    probabilities_.push_back(probability);
+    back_to_back_.push_back(back_to_back);
+    built_ = false;
+  }
+
+
+
+  G4double LineEmitter::GetTotalProbability() const
+  {
+    G4double total = 0.;
+    for (auto p: probabilities_) total += p;
+    return total;
+  }
+
+
+
+  void LineEmitter::BuildTable() const
+  {
+    G4double total = GetTotalProbability();
+    if (total > 1. + 1.e-9)
+      G4Exception("[LineEmitter]", "BuildTable()", FatalException,
+                  "Probabilities of mutually exclusive lines add up to more than one.");
+
+    // The last entry of the table stands for no emission
+    std::vector<G4double> weights(probabilities_);
+    weights.push_back(std::max(0., 1. - total));
+    table_.Build(weights.data(), weights.size());
+    built_ = true;
+  }
+
+
+
+  G4int LineEmitter::SampleLine() const
+  {
+    if (!built_) BuildTable();
+
+    size_t i = table_.Sample();
+    return (i < energies_.size()) ? G4int(i) : -1;
+  }
+
+
+
+  void LineEmitter::AddPrimaries(G4int i, G4PrimaryVertex* vertex, G4double time,
+                                 DirectionBiasing* bias) const
+  {
+    G4ThreeVector dir;
+    if (bias) {
+      G4double weight;
+      dir = bias->Sample(vertex->GetPosition(), weight, back_to_back_[i]);
+      vertex->SetWeight(vertex->GetWeight() * weight);
+    }
+    else {
+      dir = G4RandomDirection();
+    }
+
+    G4double mass = particles_[i]->GetPDGMass();
+    G4double pmod = std::sqrt(energies_[i] * (energies_[i] + 2. * mass));
+    G4ThreeVector momentum = pmod * dir;
+
+    G4PrimaryParticle* particle = new G4PrimaryParticle(particles_[i]);
+    particle->SetMomentum(momentum.x(), momentum.y(), momentum.z());
+    particle->SetPolarization(0., 0., 0.);
+    particle->SetProperTime(time);
+    vertex->SetPrimary(particle);
+
+    if (back_to_back_[i]) {
+      G4PrimaryParticle* partner = new G4PrimaryParticle(particles_[i]);
+      partner->SetMomentum(-momentum.x(), -momentum.y(), -momentum.z());
+      partner->SetPolarization(0., 0., 0.);
+      partner->SetProperTime(time);
+      vertex->SetPrimary(partner);
+    }
+  }
+
+} // namespace nexus
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------------------
+// nexus | LineEmitter.h
+//
+// Tabulated set of mutually exclusive emission lines (particle, kinetic
+// energy and probability per decay). At most one line is emitted per
+// decay, chosen in constant time with an alias table.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef LINE_EMITTER_H
+#define LINE_EMITTER_H
+
+#include "AliasTable.h"
+
+#include <vector>
+
+class G4ParticleDefinition;
+class G4PrimaryVertex;
+
+
+namespace nexus {
+
+  class DirectionBiasing;
+
+  class LineEmitter
+  {
+  public:
+    /// Constructor
+    LineEmitter();
+    /// Destructor
+    ~LineEmitter();
+
+    /// Add a line with the given kinetic energy and probability per decay.
+    /// With back_to_back set, the line consists of two particles emitted
+    /// in opposite directions (e.g. annihilation gammas).
+    void AddLine(G4ParticleDefinition* particle, G4double energy,
+                 G4double probability, G4bool back_to_back=false);
+
+    /// Return the index of a random line, or -1 if no line is emitted
+    /// (when the probabilities of the lines add up to less than one)
+    G4int SampleLine() const;
+
+    /// Create the primary particle(s) of line i with an isotropic
+    /// direction and add them to the vertex. If a direction biasing is
+    /// given, the direction is drawn from it and the weight of the
+    /// vertex is multiplied by the weight of the direction.
+    void AddPrimaries(G4int i, G4PrimaryVertex* vertex, G4double time=0.,
+                      DirectionBiasing* bias=nullptr) const;
+
+    G4ParticleDefinition* GetParticle(G4int i) const;
+    G4double GetEnergy(G4int i) const;
+    G4double GetProbability(G4int i) const;
+    size_t GetNumberOfLines() const;
+    /// Probability of emitting any of the lines in a decay
+    G4double GetTotalProbability() const;
+
+  private:
+    void BuildTable() const;
+
+  private:
+    std::vector<G4ParticleDefinition*> particles_;
+    std::vector<G4double> energies_;
+    std::vector<G4double> probabilities_;
+    std::vector<G4bool> back_to_back_;
+
+    mutable AliasTable table_; ///< Lines plus, if needed, no emission
+    mutable G4bool built_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4ParticleDefinition* LineEmitter::GetParticle(G4int i) const { return particles_[i]; }
+  inline G4double LineEmitter::GetEnergy(G4int i) const { return energies_[i]; }
+  inline G4double LineEmitter::GetProbability(G4int i) const { return probabilities_[i]; }
+  inline size_t LineEmitter::GetNumberOfLines() const { return energies_.size(); }
+
+} // namespace nexus
+
+#endif
@@ -0,0 +1,271 @@
+// ----------------------------------------------------------------------------
+// nexus | PhiloxEngine.cc
+//
+// Counter-based random number engine (Philox4x32-10, Salmon et al.,
+// SC'11). The random numbers of an event are a function of the seed
+// of the job and the event number only, so that any event can be
+// regenerated in isolation.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PhiloxEngine.h"
+
+#include <CLHEP/Random/engineIDulong.h>
+
+#include <fstream>
+#include <iostream>
+
+
+namespace {
+
+  const uint32_t PHILOX_M0 = 0xD2511F53;
+  const uint32_t PHILOX_M1 = 0xCD9E8D57;
+  const uint32_t PHILOX_W0 = 0x9E3779B9;
+  const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+  const unsigned int PHILOX_ROUNDS = 10;
+
+  inline void MulHiLo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+  {
+    uint64_t product = uint64_t(a) * uint64_t(b);
+    hi = uint32_t(product >> 32);
+    lo = uint32_t(product);
+  }
+
+} // namespace
+
+
+namespace nexus {
+
+  PhiloxEngine::PhiloxEngine(long seed): CLHEP::HepRandomEngine()
+  {
+    setSeed(seed, 0);
+  }
+
+
+
+  PhiloxEngine::~PhiloxEngine()
+  {
+  }
+
+
+
+  void PhiloxEngine::Philox(uint32_t key[2], uint32_t ctr[4])
+  {
+    for (unsigned int r=0; r<PHILOX_ROUNDS; ++r) {
+      if (r > 0) {
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+      }
+      uint32_t hi0, lo0, hi1, lo1;
+      MulHiLo(PHILOX_M0, ctr[0], hi0, lo0);
+      MulHiLo(PHILOX_M1, ctr[2], hi1, lo1);
+      uint32_t c0 = hi1 ^ ctr[1] ^ key[0];
+      uint32_t c2 = hi0 ^ ctr[3] ^ key[1];
+      ctr[0] = c0;
+      ctr[1] = lo1;
+      ctr[2] = c2;
+      ctr[3] = lo0;
+    }
+  }
+
+
+
+  void PhiloxEngine::SetEvent(uint64_t event)
+  {
+    counter_[0] = 0;
+    counter_[1] = 0;
+    counter_[2] = uint32_t(event);
+    counter_[3] = uint32_t(event >> 32);
+    for (unsigned int i=0; i<4; ++i) block_[i] = 0;
+    used_ = 4;
+  }
+
+
+
+  void PhiloxEngine::Refill()
+  {
+    uint32_t key[2] = {key_[0], key_[1]};
+    for (unsigned int i=0; i<4; ++i) block_[i] = counter_[i];
+    Philox(key, block_);
+
+    // The low words of the counter number the blocks of the stream
+    if (++counter_[0] == 0) ++counter_[1];
+    used_ = 0;
+  }
+
+
+
+  uint32_t PhiloxEngine::Next()
+  {
+    if (used_ == 4) Refill();
+    return block_[used_++];
+  }
+
+
+
+  double PhiloxEngine::flat()
+  {
+    // 53 random bits, shifted by half a unit so that the
+    // result lies in the open interval (0,1)
+    uint64_t a = Next() >> 5;
+    uint64_t b = Next() >> 6;
+    return ((a << 26) + b + 0.5) * (1.0 / 9007199254740992.0);
+  }
+
+
+
+  void PhiloxEngine::flatArray(const int size, double* vect)
+  {
+    for (int i=0; i<size; ++i) vect[i] = flat();
+  }
+
+
+
+  void PhiloxEngine::setSeed(long seed, int)
+  {
+    theSeed = seed;
+    uint64_t s = uint64_t(seed);
+    key_[0] = uint32_t(s);
+    key_[1] = uint32_t(s >> 32);
+    SetEvent(0);
+  }
+
+
+
+  void PhiloxEngine::setSeeds(const long* seeds, int)
+  {
+    if (seeds && seeds[0]) setSeed(seeds[0], 0);
+  }
+
+
+
+  void PhiloxEngine::saveStatus(const char filename[]) const
+  {
+    std::ofstream outfile(filename, std::ios::out);
+    if (!outfile.bad()) put(outfile);
+  }
+
+
+
+  void PhiloxEngine::restoreStatus(const char filename[])
+  {
+    std::ifstream infile(filename, std::ios::in);
+    if (!infile) {
+      std::cerr << "  -- Engine state remains unchanged" << std::endl;
+      return;
+    }
+    get(infile);
+  }
+
+
+
+  void PhiloxEngine::showStatus() const
+  {
+    std::cout << "--------- Philox engine status ---------" << std::endl;
+    std::cout << " Key     = " << key_[0] << " " << key_[1] << std::endl;
+    std::cout << " Counter = " << counter_[0] << " " << counter_[1] << " "
+              << counter_[2] << " " << counter_[3] << std::endl;
+    std::cout << " Used    = " << used_ << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+  }
+
+
+
+  std::string PhiloxEngine::name() const
+  {
+    return engineName();
+  }
+
+
+
+  std::string PhiloxEngine::engineName()
+  {
+    return "PhiloxEngine";
+  }
+
+
+
+  std::ostream& PhiloxEngine::put(std::ostream& os) const
+  {
+    os << engineName() << "-begin\n";
+    std::vector<unsigned long> v = put();
+    for (size_t i=0; i<v.size(); ++i) os << v[i] << "\n";
+    os << engineName() << "-end\n";
+    return os;
+  }
+
+
+
+  std::istream& PhiloxEngine::get(std::istream& is)
+  {
+    std::string begin;
+    is >> begin;
+    if (begin != engineName() + "-begin") {
+      is.clear(std::ios::badbit | is.rdstate());
+      std::cerr << "No " << engineName() << " found at current position\n";
+      return is;
+    }
+    return getState(is);
+  }
+
+
+
+  std::istream& PhiloxEngine::getState(std::istream& is)
+  {
+    std::vector<unsigned long> v(12);
+    for (size_t i=0; i<v.size(); ++i) is >> v[i];
+
+    std::string end;
+    is >> end;
+    if (!is || end != engineName() + "-end" || !get(v)) {
+      is.clear(std::ios::badbit | is.rdstate());
+      std::cerr << "Invalid " << engineName() << " state\n";
+    }
+    return is;
+  }
+
+
+
+  std::vector<unsigned long> PhiloxEngine::put() const
+  {
+    std::vector<unsigned long> v;
+    v.push_back(CLHEP::engineIDulong<PhiloxEngine>());
+    v.push_back(key_[0]);
+    v.push_back(key_[1]);
+    for (unsigned int i=0; i<4; ++i) v.push_back(counter_[i]);
+    for (unsigned int i=0; i<4; ++i) v.push_back(block_[i]);
+    v.push_back(used_);
+    return v;
+  }
+
+
+
+  bool PhiloxEngine::get(const std::vector<unsigned long>& v)
+  {
+    if (v.empty() || v[0] != CLHEP::engineIDulong<PhiloxEngine>()) {
+      std::cerr << "\nPhiloxEngine get:state vector has wrong ID word - state unchanged\n";
+      return false;
+    }
+    return getState(v);
+  }
+
+
+
+  bool PhiloxEngine::getState(const std::vector<unsigned long>& v)
+  {
+    if (v.size() != 12 || v[11] > 4) {
+      std::cerr << "\nPhiloxEngine get:state vector has wrong length - state unchanged\n";
+      return false;
+    }
+    key_[0] = uint32_t(v[1]);
+    key_[1] = uint32_t(v[2]);
+    for (unsigned int i=0; i<4; ++i) counter_[i] = uint32_t(v[3+i]);
+    for (unsigned int i=0; i<4; ++i) block_[i] = uint32_t(v[7+i]);
+    used_ = (unsigned int)v[11];
+    theSeed = long((uint64_t(key_[1]) << 32) | key_[0]);
+    return true;
+  }
+
+} // namespace nexus
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------
+// nexus | PhiloxEngine.h
+//
+// Counter-based random number engine (Philox4x32-10, Salmon et al.,
+// SC'11). The random numbers of an event are a function of the seed
+// of the job and the event number only, so that any event can be
+// regenerated in isolation.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PHILOX_ENGINE_H
+#define PHILOX_ENGINE_H
+
+#include <CLHEP/Random/RandomEngine.h>
+
+#include <cstdint>
+
+
+namespace nexus {
+
+  class PhiloxEngine: public CLHEP::HepRandomEngine
+  {
+  public:
+    /// Constructor
+    PhiloxEngine(long seed=19780503);
+    /// Destructor
+    virtual ~PhiloxEngine();
+
+    /// Start the random stream of a given event. The stream only depends
+    /// on the seed of the engine and the event number.
+    void SetEvent(uint64_t event);
+
+    /// Return the 4x32-bit block of random bits for a given key and
+    /// counter. Both are modified: they are not needed afterwards.
+    static void Philox(uint32_t key[2], uint32_t ctr[4]);
+
+    // Methods of the HepRandomEngine interface
+
+    virtual double flat();
+    virtual void flatArray(const int size, double* vect);
+    virtual void setSeed(long seed, int);
+    virtual void setSeeds(const long* seeds, int);
+    virtual void saveStatus(const char filename[] = "Philox.conf") const;
+    virtual void restoreStatus(const char filename[] = "Philox.conf");
+    virtual void showStatus() const;
+    virtual std::string name() const;
+    static std::string engineName();
+
+    virtual std::ostream& put(std::ostream& os) const;
+    virtual std::istream& get(std::istream& is);
+    virtual std::istream& getState(std::istream& is);
+
+    virtual std::vector<unsigned long> put() const;
+    virtual bool get(const std::vector<unsigned long>& v);
+    virtual bool getState(const std::vector<unsigned long>& v);
+
+  private:
+    /// Generate the next block of random bits
+    void Refill();
+    /// Next 32 random bits
+    uint32_t Next();
+
+  private:
+    uint32_t key_[2];    ///< Seed of the job
+    uint32_t counter_[4];///< Draw number (low words) and event (high words)
+    uint32_t block_[4];  ///< Current block of random bits
+    unsigned int used_;  ///< Number of words of the block already used
+  };
+
+} // namespace nexus
+
+#endif
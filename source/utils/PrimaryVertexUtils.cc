@@ -0,0 +1,33 @@
+// ----------------------------------------------------------------------------
+// nexus | PrimaryVertexUtils.cc
+//
+// Functions shared by the generators that combine several decays
+// in the same event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PrimaryVertexUtils.h"
+
+#include <G4Event.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4VPrimaryGenerator.hh>
+
+
+namespace nexus {
+
+  void GenerateDelayedVertices(G4VPrimaryGenerator& generator,
+                               G4Event* event, G4double t0)
+  {
+    // The vertices already in the event are left untouched
+    G4int first = event->GetNumberOfPrimaryVertex();
+    generator.GeneratePrimaryVertex(event);
+
+    if (t0 == 0.) return;
+    for (G4int v=first; v<event->GetNumberOfPrimaryVertex(); ++v) {
+      G4PrimaryVertex* vertex = event->GetPrimaryVertex(v);
+      vertex->SetT0(vertex->GetT0() + t0);
+    }
+  }
+
+}
@@ -0,0 +1,28 @@
+// ----------------------------------------------------------------------------
+// nexus | PrimaryVertexUtils.h
+//
+// Functions shared by the generators that combine several decays
+// in the same event.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PRIMARY_VERTEX_UTILS_H
+#define PRIMARY_VERTEX_UTILS_H
+
+#include <globals.hh>
+
+class G4Event;
+class G4VPrimaryGenerator;
+
+
+namespace nexus {
+
+  /// Let the generator add its primary vertices to the event and
+  /// delay the start time of the new vertices by t0
+  void GenerateDelayedVertices(G4VPrimaryGenerator& generator,
+                               G4Event* event, G4double t0);
+
+}
+
+#endif
@@ -11,6 +11,62 @@
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+  // Standard normal cumulative distribution
+  G4double NormalCDF(G4double x)
+  {
+    return 0.5 * std::erfc(-x / std::sqrt(2.));
+  }
+
+  // Inverse of the standard normal cumulative distribution
+  // (rational approximation by P. J. Acklam refined with
+  // one step of Halley's method)
+  G4double InverseNormalCDF(G4double p)
+  {
+    static const G4double a[] = {-3.969683028665376e+01,  2.209460984245205e+02,
+                                 -2.759285104469687e+02,  1.383577518672690e+02,
+                                 -3.066479806614716e+01,  2.506628277459239e+00};
+    static const G4double b[] = {-5.447609879822406e+01,  1.615858368580409e+02,
+                                 -1.556989798598866e+02,  6.680131188771972e+01,
+                                 -1.328068155288572e+01};
+    static const G4double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                                 -2.400758277161838e+00, -2.549732539343734e+00,
+                                  4.374664141464968e+00,  2.938163982698783e+00};
+    static const G4double d[] = { 7.784695709041462e-03,  3.224671290700398e-01,
+                                  2.445134137142996e+00,  3.754408661907416e+00};
+
+    if (p <= 0.) return -HUGE_VAL;
+    if (p >= 1.) return  HUGE_VAL;
+
+    G4double x;
+    if (p < 0.02425) {
+      G4double q = std::sqrt(-2. * std::log(p));
+      x = (((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) /
+          ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1.);
+    }
+    else if (p > 1. - 0.02425) {
+      G4double q = std::sqrt(-2. * std::log(1. - p));
+      x = -(((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) /
+           ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1.);
+    }
+    else {
+      G4double q = p - 0.5;
+      G4double r = q * q;
+      x = (((((a[0]*r+a[1])*r+a[2])*r+a[3])*r+a[4])*r+a[5])*q /
+          (((((b[0]*r+b[1])*r+b[2])*r+b[3])*r+b[4])*r+1.);
+    }
+
+    G4double e = NormalCDF(x) - p;
+    G4double u = e * std::sqrt(2. * CLHEP::pi) * std::exp(x * x / 2.);
+    return x - u / (1. + x * u / 2.);
+  }
+
+}
+
 namespace nexus {
 
   G4double UniformRandomInRange(G4double max_value, G4double min_value)
@@ -39,4 +95,55 @@ namespace nexus {
   }
 
 
+  G4double GaussianProbabilityInRange(G4double mean, G4double sigma,
+                                      G4double min_value, G4double max_value)
+  {
+    if (sigma <= 0.)
+      return (mean >= min_value && mean <= max_value) ? 1. : 0.;
+
+    G4double a = (min_value - mean) / sigma;
+    G4double b = (max_value - mean) / sigma;
+    // Use the tail closer to the interval to keep the precision
+    if (a > 0.) return NormalCDF(-a) - NormalCDF(-b);
+    return NormalCDF(b) - NormalCDF(a);
+  }
+
+
+  G4double TruncatedGaussian(G4double mean, G4double sigma,
+                             G4double min_value, G4double max_value)
+  {
+    if (sigma <= 0.)
+      return mean;
+
+    // Plain rejection is cheaper as long as most of the
+    // distribution lies within the interval
+    if (GaussianProbabilityInRange(mean, sigma, min_value, max_value) > 0.3) {
+      G4double x;
+      do {
+        x = G4RandGauss::shoot(mean, sigma);
+      } while (x < min_value || x > max_value);
+      return x;
+    }
+
+    // Otherwise, invert the cumulative distribution. If the interval
+    // lies in the upper tail, work with the mirrored distribution
+    // so that the cumulative probabilities stay far from 1.
+    G4double a = (min_value - mean) / sigma;
+    G4double b = (max_value - mean) / sigma;
+    G4double sign = 1.;
+    if (a > 0.) {
+      G4double tmp = a;
+      a = -b;
+      b = -tmp;
+      sign = -1.;
+    }
+
+    G4double pa = NormalCDF(a);
+    G4double pb = NormalCDF(b);
+    G4double x  = InverseNormalCDF(pa + G4UniformRand() * (pb - pa));
+    x = std::max(a, std::min(b, x));
+
+    return mean + sign * sigma * x;
+  }
+
 }
@@ -19,6 +19,14 @@ namespace nexus {
   G4ThreeVector RandomDirectionInRange(G4double costheta_min, G4double costheta_max,
                                        G4double phi_min, G4double phi_max);
 
+  /// Probability that a Gaussian variable lies within [min_value, max_value]
+  G4double GaussianProbabilityInRange(G4double mean, G4double sigma,
+                                      G4double min_value, G4double max_value);
+
+  /// Random number from a Gaussian truncated to [min_value, max_value]
+  G4double TruncatedGaussian(G4double mean, G4double sigma,
+                             G4double min_value, G4double max_value);
+
 }
 
 #endif